@@ -0,0 +1,113 @@
+#ifndef     _BIDSNAPSHOT_HPP_
+# define    _BIDSNAPSHOT_HPP_
+
+# include <cstdint>
+# include <memory>
+# include <stdexcept>
+# include <string>
+# include <string_view>
+# include <unordered_map>
+# include <vector>
+
+# include "CSVparser.hpp"
+
+/*
+** Binary snapshot of a bid collection, written after a CSV load so the
+** next start can map it instead of parsing text again.
+**
+** Layout (native byte order) :
+**   Header     magic, version, record count, source file size/time,
+**              flags (HAS_DATES when the close dates were recorded)
+**   Record[]   fixed width : offset/length of id, title and fund in the
+**              string table, close date as yyyymmdd, amount in cents
+**   strings    string table, identical strings are stored once
+*/
+namespace snapshot
+{
+    class Error : public std::runtime_error
+    {
+
+      public:
+        Error(const std::string &msg):
+          std::runtime_error(std::string("BidSnapshot : ").append(msg))
+        {
+        }
+    };
+
+    struct Header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t count;
+        std::uint64_t sourceSize;
+        std::int64_t sourceTime;
+        std::uint64_t stringsSize;
+        std::uint64_t flags;
+    };
+
+    // Header::flags
+    static const std::uint64_t HAS_DATES = 1;
+
+    struct Record
+    {
+        std::uint32_t offset[3];
+        std::uint32_t length[3];
+        std::uint32_t closeDate;    // yyyymmdd, 0 when unknown
+        std::uint32_t reserved;     // zero, keeps amount aligned
+        std::int64_t amount;
+    };
+
+    std::string pathFor(const std::string &csvPath);
+
+    class Writer
+    {
+
+    public:
+        Writer(void);
+
+    public:
+        void add(std::string_view bidId, std::string_view title,
+                 std::string_view fund, long long amount);
+        void add(std::string_view bidId, std::string_view title,
+                 std::string_view fund, long long amount,
+                 const csv::Date &closeDate);
+        void write(const std::string &path, const std::string &source) const;
+
+    private:
+        std::uint32_t intern(std::string_view, std::uint32_t &);
+
+    private:
+        std::vector<Record> _records;
+        std::string _strings;
+        std::unordered_map<std::string, std::uint32_t> _offsets;
+        std::uint64_t _flags;
+    };
+
+    class Reader
+    {
+
+    public:
+        Reader(const std::string &path);
+
+    public:
+        bool fresh(const std::string &source) const;
+        unsigned int size(void) const;
+        std::string_view bidId(unsigned int) const;
+        std::string_view title(unsigned int) const;
+        std::string_view fund(unsigned int) const;
+        long long amount(unsigned int) const;
+        bool hasDates(void) const;
+        csv::Date closeDate(unsigned int) const;
+
+    private:
+        std::string_view field(unsigned int, int) const;
+
+    private:
+        std::unique_ptr<csv::MappedFile> _file;
+        const Header *_header;
+        const Record *_records;
+        const char *_strings;
+    };
+}
+
+#endif /*!_BIDSNAPSHOT_HPP_*/
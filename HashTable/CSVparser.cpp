@@ -1,12 +1,193 @@
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 #include "CSVparser.hpp"
 
+#if defined(_MSC_VER)
+# include <intrin.h>
+#elif defined(__SSE2__)
+# include <immintrin.h>
+#endif
+
+#ifdef _WIN32
+# ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+# endif
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
 namespace csv {
 
-  Parser::Parser(const std::string &data, const DataType &type, char sep)
-    : _type(type), _sep(sep)
+  /*
+  ** Record scanner. Finds the end of the record starting at begin (the
+  ** first newline, or end) and calls onSep for every separator outside
+  ** quotes. With SSE2/AVX2 the bytes are classified 16/32 at a time: the
+  ** quote bitmask is turned into an "inside quotes" mask by a prefix xor
+  ** which is carried from one block into the next. Define
+  ** CSVPARSER_NO_SIMD to force the scalar loop.
+  */
+
+#if !defined(CSVPARSER_NO_SIMD) && defined(__AVX2__)
+# define CSVPARSER_SIMD
+  static const int BLOCK = 32;
+
+  static inline void classify(const char *p, char sep, unsigned int &quotes,
+                              unsigned int &seps, unsigned int &eols)
+  {
+      __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+      quotes = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')));
+      seps = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(sep)));
+      eols = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+  }
+#elif !defined(CSVPARSER_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || \
+      (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+# define CSVPARSER_SIMD
+  static const int BLOCK = 16;
+
+  static inline void classify(const char *p, char sep, unsigned int &quotes,
+                              unsigned int &seps, unsigned int &eols)
+  {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+      quotes = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')));
+      seps = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(sep)));
+      eols = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+  }
+#endif
+
+#ifdef CSVPARSER_SIMD
+  static inline unsigned int lowestBit(unsigned int mask)
+  {
+#ifdef _MSC_VER
+      unsigned long pos;
+      _BitScanForward(&pos, mask);
+      return pos;
+#else
+      return __builtin_ctz(mask);
+#endif
+  }
+#endif
+
+  /*
+  ** byte at a time loop, the whole scanner without SIMD; quoted tells
+  ** whether p starts inside quotes
+  */
+  template<typename F>
+  static const char *scanBytes(const char *p, const char *end, char sep,
+                               bool quoted, F onSep)
+  {
+      for (; p != end && *p != '\n'; p++)
+      {
+          if (*p == '"')
+              quoted = !quoted;
+          else if (*p == sep && !quoted)
+              onSep(p);
+      }
+      return p;
+  }
+
+  template<typename F>
+  static const char *scanRecord(const char *begin, const char *end, char sep, F onSep)
+  {
+      const char *p = begin;
+      unsigned int carry = 0;
+
+#ifdef CSVPARSER_SIMD
+      for (; end - p >= BLOCK; p += BLOCK)
+      {
+          unsigned int quotes, seps, eols;
+          classify(p, sep, quotes, seps, eols);
+
+          // bit i set when byte i sits after an odd number of quotes
+          unsigned int inside = quotes;
+          for (int shift = 1; shift < BLOCK; shift <<= 1)
+              inside ^= inside << shift;
+          inside ^= carry;
+
+          seps &= ~inside;
+          if (eols != 0)
+              seps &= (1u << lowestBit(eols)) - 1;
+          for (; seps != 0; seps &= seps - 1)
+              onSep(p + lowestBit(seps));
+          if (eols != 0)
+              return p + lowestBit(eols);
+
+          carry = ((inside >> (BLOCK - 1)) & 1) ? ~0u : 0u;
+      }
+#endif
+
+      return scanBytes(p, end, sep, carry != 0, onSep);
+  }
+
+  const char *scannerName(void)
+  {
+#ifdef CSVPARSER_SIMD
+      return (BLOCK == 32) ? "AVX2" : "SSE2";
+#else
+      return "scalar";
+#endif
+  }
+
+  std::size_t countSeparators(const MappedFile &file, char sep, bool bytes)
+  {
+      const char *p = file.data();
+      const char *end = p + file.size();
+      std::size_t count = 0;
+      auto onSep = [&count](const char *) { count++; };
+
+      while (p < end)
+      {
+          const char *stop = bytes ? scanBytes(p, end, sep, false, onSep)
+                                   : scanRecord(p, end, sep, onSep);
+          p = (stop != end) ? stop + 1 : end;
+      }
+      return count;
+  }
+
+  /*
+  ** split one line on unquoted separators and push each selected field
+  ** in the row, returns the number of fields found in the line
+  */
+  static unsigned int tokenize(const std::string &line, char sep, Row &row,
+                               const Columns &columns)
+  {
+      const char *tokenStart = line.data();
+      const char *stop;
+      unsigned int column = 0;
+
+      stop = scanRecord(line.data(), line.data() + line.length(), sep,
+                        [&](const char *it)
+                        {
+                            if (columns.selects(column))
+                                row.push(std::string(tokenStart, it));
+                            tokenStart = it + 1;
+                            column++;
+                        });
+
+      //end
+      if (columns.selects(column))
+          row.push(std::string(tokenStart, stop));
+      return column + 1;
+  }
+
+  Parser::Parser(const std::string &data, const DataType &type, char sep,
+                 const Columns &columns)
+    : _type(type), _sep(sep), _columns(columns), _width(0)
   {
       std::string line;
       if (type == eFILE)
@@ -61,6 +242,11 @@ namespace csv {
 
       while (std::getline(ss, item, _sep))
           _header.push_back(item);
+
+      // rows only keep the projected columns, so does the header
+      _width = _header.size();
+      _columns.resolve(_header);
+      _header = _columns.project(_header);
   }
 
   void Parser::parseContent(void)
@@ -72,29 +258,14 @@ namespace csv {
 
      for (; it != _originalFile.end(); it++)
      {
-         bool quoted = false;
-         int tokenStart = 0;
-         unsigned int i = 0;
-
          Row *row = new Row(_header);
 
-         for (; i != it->length(); i++)
-         {
-              if (it->at(i) == '"')
-                  quoted = ((quoted) ? (false) : (true));
-              else if (it->at(i) == ',' && !quoted)
-              {
-                  row->push(it->substr(tokenStart, i - tokenStart));
-                  tokenStart = i + 1;
-              }
-         }
-
-         //end
-         row->push(it->substr(tokenStart, it->length() - tokenStart));
-
          // if value(s) missing
-         if (row->size() != _header.size())
+         if (tokenize(*it, _sep, *row, _columns) != _width)
+         {
+          delete row;
           throw Error("corrupted data !");
+         }
          _content.push_back(row);
      }
   }
@@ -161,6 +332,8 @@ namespace csv {
 
   void Parser::sync(void) const
   {
+    if (!_columns.all())
+      throw Error("can't sync a projected file");
     if (_type == DataType::eFILE)
     {
       std::ofstream f;
@@ -189,6 +362,530 @@ namespace csv {
       return _file;    
   }
   
+  /*
+  ** MAPPED FILE
+  */
+
+#ifdef _WIN32
+  MappedFile::MappedFile(const std::string &file)
+    : _file(file), _data(NULL), _size(0),
+      _handle(INVALID_HANDLE_VALUE), _mapping(NULL)
+  {
+      _handle = CreateFileA(_file.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+      if (_handle == INVALID_HANDLE_VALUE)
+          throw Error(std::string("Failed to open ").append(_file));
+
+      LARGE_INTEGER size;
+      if (!GetFileSizeEx(_handle, &size))
+      {
+          CloseHandle(_handle);
+          throw Error(std::string("Failed to open ").append(_file));
+      }
+      _size = static_cast<std::size_t>(size.QuadPart);
+      if (_size == 0)
+          return;
+
+      _mapping = CreateFileMappingA(_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+      if (_mapping != NULL)
+          _data = static_cast<const char *>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+      if (_data == NULL)
+      {
+          if (_mapping != NULL)
+              CloseHandle(_mapping);
+          CloseHandle(_handle);
+          throw Error(std::string("Failed to map ").append(_file));
+      }
+  }
+
+  MappedFile::~MappedFile(void)
+  {
+      if (_data != NULL)
+          UnmapViewOfFile(_data);
+      if (_mapping != NULL)
+          CloseHandle(_mapping);
+      CloseHandle(_handle);
+  }
+#else
+  MappedFile::MappedFile(const std::string &file)
+    : _file(file), _data(NULL), _size(0)
+  {
+      int fd = open(_file.c_str(), O_RDONLY);
+      if (fd < 0)
+          throw Error(std::string("Failed to open ").append(_file));
+
+      struct stat st;
+      if (fstat(fd, &st) != 0)
+      {
+          close(fd);
+          throw Error(std::string("Failed to open ").append(_file));
+      }
+      _size = static_cast<std::size_t>(st.st_size);
+      if (_size == 0)
+      {
+          close(fd);
+          return;
+      }
+
+      void *addr = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+      close(fd);
+      if (addr == MAP_FAILED)
+          throw Error(std::string("Failed to map ").append(_file));
+      madvise(addr, _size, MADV_SEQUENTIAL);
+      _data = static_cast<const char *>(addr);
+  }
+
+  MappedFile::~MappedFile(void)
+  {
+      if (_data != NULL)
+          munmap(const_cast<char *>(_data), _size);
+  }
+#endif
+
+  const char *MappedFile::data(void) const
+  {
+      return _data;
+  }
+
+  std::size_t MappedFile::size(void) const
+  {
+      return _size;
+  }
+
+  const std::string &MappedFile::getFileName(void) const
+  {
+      return _file;
+  }
+
+  /*
+  ** CURSOR
+  */
+
+  std::string unquote(std::string_view field)
+  {
+      if (field.size() < 2 || field.front() != '"' || field.back() != '"')
+          return std::string(field);
+
+      // drop the outer quotes and collapse doubled ones
+      std::string value;
+      value.reserve(field.size() - 2);
+      for (std::size_t i = 1; i + 1 < field.size(); i++)
+      {
+          value.push_back(field[i]);
+          if (field[i] == '"' && field[i + 1] == '"')
+              i++;
+      }
+      return value;
+  }
+
+  Cursor::Cursor(const char *begin, const char *end, char sep,
+                 unsigned int width, const Columns &columns)
+    : _pos(begin), _end(end), _sep(sep), _width(width), _columns(columns)
+  {
+      // without a header row the projection must be resolvable by index
+      if (_width != 0 && !_columns.resolved())
+          _columns.resolve(std::vector<std::string>(_width));
+  }
+
+  Cursor::Cursor(const MappedFile &file, char sep, const Columns &columns)
+    : _pos(file.data()), _end(file.data() + file.size()), _sep(sep),
+      _width(0), _columns(columns)
+  {
+  }
+
+  bool Cursor::next(void)
+  {
+      while (_pos < _end)
+      {
+          const char *line = _pos;
+          const char *tokenStart = line;
+          const char *stop;
+          unsigned int column = 0;
+
+          // the first record (header) is always kept whole
+          const bool project = (_width != 0 && !_columns.all());
+
+          _fields.clear();
+          stop = scanRecord(line, _end, _sep,
+                            [&](const char *it)
+                            {
+                                if (!project || _columns.selects(column))
+                                    _fields.emplace_back(tokenStart, it - tokenStart);
+                                tokenStart = it + 1;
+                                column++;
+                            });
+
+          _pos = (stop != _end) ? stop + 1 : _end;
+          if (stop > tokenStart && stop[-1] == '\r')
+              stop--;
+          if (stop == line)
+              continue;
+          if (!project || _columns.selects(column))
+              _fields.emplace_back(tokenStart, stop - tokenStart);
+          column++;
+
+          // first record fixes the width, later ones must match it
+          if (_width == 0)
+          {
+              _width = column;
+              if (!_columns.resolved())
+                  _columns.resolve(std::vector<std::string>(_fields.begin(), _fields.end()));
+          }
+          else if (column != _width)
+              throw Error("corrupted data !");
+          return true;
+      }
+      return false;
+  }
+
+  unsigned int Cursor::size(void) const
+  {
+      return _fields.size();
+  }
+
+  unsigned int Cursor::columnCount(void) const
+  {
+      return _width;
+  }
+
+  const Columns &Cursor::columns(void) const
+  {
+      return _columns;
+  }
+
+  std::string_view Cursor::operator[](unsigned int valuePosition) const
+  {
+      if (valuePosition < _fields.size())
+          return _fields[valuePosition];
+      throw Error("can't return this value (doesn't exist)");
+  }
+
+  std::string Cursor::unquote(unsigned int valuePosition) const
+  {
+      return csv::unquote((*this)[valuePosition]);
+  }
+
+  const char *Cursor::position(void) const
+  {
+      return _pos;
+  }
+
+  static std::string normalize(std::string_view name)
+  {
+      while (!name.empty() && std::isspace(static_cast<unsigned char>(name.front())))
+          name.remove_prefix(1);
+      while (!name.empty() && std::isspace(static_cast<unsigned char>(name.back())))
+          name.remove_suffix(1);
+
+      std::string lower(name);
+      for (auto &c : lower)
+          c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+      return lower;
+  }
+
+  bool findColumn(const Cursor &header, const std::string &spec, unsigned int &index)
+  {
+      if (!spec.empty() && std::all_of(spec.begin(), spec.end(),
+                                          [](char c) { return c >= '0' && c <= '9'; }))
+      {
+          if (spec.size() > 9 || std::stoul(spec) >= header.size())
+              return false;
+          index = static_cast<unsigned int>(std::stoul(spec));
+          return true;
+      }
+
+      std::string wanted = normalize(spec);
+      for (unsigned int i = 0; i < header.size(); i++)
+          if (normalize(header.unquote(i)) == wanted)
+          {
+              index = i;
+              return true;
+          }
+      return false;
+  }
+
+  /*
+  ** DECODERS
+  */
+
+  // strip the blanks and the quotes a field may be wrapped in
+  static std::string_view trim(std::string_view field)
+  {
+      while (!field.empty() && (field.front() == ' ' || field.front() == '"'))
+          field.remove_prefix(1);
+      while (!field.empty() && (field.back() == ' ' || field.back() == '"'
+                                || field.back() == '\r'))
+          field.remove_suffix(1);
+      return field;
+  }
+
+  bool toInteger(std::string_view field, long long &value)
+  {
+      field = trim(field);
+
+      long long result;
+      const char *end = field.data() + field.size();
+      std::from_chars_result res = std::from_chars(field.data(), end, result);
+      if (res.ec != std::errc() || res.ptr != end)
+          return false;
+      value = result;
+      return true;
+  }
+
+  /*
+  ** "$3,000 ", "1.5", "-$0.25", "($12.00)" ; fractions past the cents
+  ** are rounded half away from zero
+  */
+  bool toCents(std::string_view field, long long &value)
+  {
+      field = trim(field);
+
+      bool negative = false;
+      if (!field.empty() && (field.front() == '-' || field.front() == '('))
+      {
+          negative = true;
+          if (field.front() == '(' && (field.size() < 2 || field.back() != ')'))
+              return false;
+          if (field.front() == '(')
+              field.remove_suffix(1);
+          field.remove_prefix(1);
+      }
+      if (!field.empty() && field.front() == '$')
+          field.remove_prefix(1);
+
+      std::size_t i = 0;
+      long long cents = 0;
+      bool digits = false;
+
+      for (; i < field.size() && field[i] != '.'; i++)
+      {
+          if (field[i] == ',')
+              continue;
+          if (field[i] < '0' || field[i] > '9')
+              return false;
+          cents = cents * 10 + (field[i] - '0');
+          digits = true;
+      }
+      cents *= 100;
+
+      if (i < field.size())
+      {
+          static const int weight[] = { 10, 1 };
+          int place = 0;
+          for (i++; i < field.size(); i++, place++)
+          {
+              if (field[i] < '0' || field[i] > '9')
+                  return false;
+              if (place < 2)
+                  cents += (field[i] - '0') * weight[place];
+              else if (place == 2 && field[i] >= '5')
+                  cents++;
+              digits = true;
+          }
+      }
+      if (!digits)
+          return false;
+
+      value = negative ? -cents : cents;
+      return true;
+  }
+
+  // month/day/year, as in the eBid exports
+  bool toDate(std::string_view field, Date &value)
+  {
+      field = trim(field);
+
+      int parts[3];
+      const char *it = field.data();
+      const char *end = field.data() + field.size();
+
+      for (int i = 0; i < 3; i++)
+      {
+          std::from_chars_result res = std::from_chars(it, end, parts[i]);
+          if (res.ec != std::errc())
+              return false;
+          it = res.ptr;
+          if (i < 2)
+          {
+              if (it == end || *it != '/')
+                  return false;
+              it++;
+          }
+      }
+      if (it != end || parts[0] < 1 || parts[0] > 12 || parts[1] < 1 || parts[1] > 31)
+          return false;
+
+      value.month = parts[0];
+      value.day = parts[1];
+      value.year = parts[2];
+      return true;
+  }
+
+  /*
+  ** SYMBOL
+  */
+
+  namespace
+  {
+      // the interned strings; a deque never moves its elements, so the
+      // map keys and the Symbol pointers stay valid as it grows
+      struct SymbolTable
+      {
+          std::shared_mutex lock;
+          std::deque<std::string> strings;
+          std::unordered_map<std::string_view, const std::string *> index;
+      };
+
+      SymbolTable &symbols(void)
+      {
+          static SymbolTable table;
+          return table;
+      }
+
+      // default constructed Symbols share it without taking the lock
+      const std::string *emptySymbol(void)
+      {
+          static const std::string empty;
+          return &empty;
+      }
+
+      const std::string *intern(std::string_view value)
+      {
+          if (value.empty())
+              return emptySymbol();
+
+          SymbolTable &table = symbols();
+
+          {
+              std::shared_lock<std::shared_mutex> guard(table.lock);
+              auto it = table.index.find(value);
+              if (it != table.index.end())
+                  return it->second;
+          }
+
+          std::unique_lock<std::shared_mutex> guard(table.lock);
+          auto it = table.index.find(value);
+          if (it != table.index.end())
+              return it->second;
+          table.strings.emplace_back(value);
+          const std::string *interned = &table.strings.back();
+          table.index.emplace(*interned, interned);
+          return interned;
+      }
+  }
+
+  Symbol::Symbol(void)
+      : _value(emptySymbol()) {}
+
+  Symbol::Symbol(std::string_view value)
+      : _value(intern(value)) {}
+
+  Symbol::Symbol(const std::string &value)
+      : _value(intern(value)) {}
+
+  Symbol::Symbol(const char *value)
+      : _value(intern(value)) {}
+
+  std::size_t Symbol::distinctCount(void)
+  {
+      SymbolTable &table = symbols();
+      std::shared_lock<std::shared_mutex> guard(table.lock);
+      return table.strings.size();
+  }
+
+  std::ostream &operator<<(std::ostream &os, const Symbol &symbol)
+  {
+      return os << symbol.str();
+  }
+
+  std::istream &operator>>(std::istream &is, Symbol &symbol)
+  {
+      std::string value;
+      if (is >> value)
+          symbol = Symbol(value);
+      return is;
+  }
+
+  /*
+  ** records never span lines (same as Parser), so the byte after the
+  ** first newline past a split point is always a safe place to cut
+  */
+  std::vector<Chunk> split(const char *begin, const char *end, unsigned int count)
+  {
+      std::vector<Chunk> chunks;
+      std::size_t step = (count > 1) ? (end - begin) / count : (end - begin);
+
+      while (begin < end)
+      {
+          const char *stop = end;
+          if (chunks.size() + 1 < count && static_cast<std::size_t>(end - begin) > step)
+          {
+              stop = static_cast<const char *>(std::memchr(begin + step, '\n', end - begin - step));
+              stop = (stop != NULL) ? stop + 1 : end;
+          }
+          chunks.push_back(Chunk(begin, stop));
+          begin = stop;
+      }
+      return chunks;
+  }
+
+  /*
+  ** COLUMNS
+  */
+
+  Columns::Columns(void)
+      : _all(true), _resolved(false) {}
+
+  Columns::Columns(std::initializer_list<unsigned int> indices)
+      : _indices(indices), _all(false), _resolved(false) {}
+
+  Columns::Columns(const std::vector<std::string> &names)
+      : _names(names), _all(false), _resolved(false) {}
+
+  void Columns::resolve(const std::vector<std::string> &header)
+  {
+    _resolved = true;
+    if (_all)
+      return;
+
+    _mask.assign(header.size(), false);
+    for (auto it = _indices.begin(); it != _indices.end(); it++)
+    {
+      if (*it >= header.size())
+        throw Error("can't select this column (doesn't exist)");
+      _mask[*it] = true;
+    }
+    for (auto it = _names.begin(); it != _names.end(); it++)
+    {
+      unsigned int pos = 0;
+      while (pos < header.size() && header[pos] != *it)
+        pos++;
+      if (pos == header.size())
+        throw Error(std::string("can't select column ").append(*it));
+      _mask[pos] = true;
+    }
+  }
+
+  bool Columns::resolved(void) const
+  {
+    return _resolved;
+  }
+
+  bool Columns::all(void) const
+  {
+    return _all;
+  }
+
+  std::vector<std::string> Columns::project(const std::vector<std::string> &values) const
+  {
+    std::vector<std::string> result;
+
+    for (unsigned int i = 0; i < values.size(); i++)
+      if (selects(i))
+        result.push_back(values[i]);
+    return result;
+  }
+
   /*
   ** ROW
   */
@@ -208,6 +905,11 @@ namespace csv {
     _values.push_back(value);
   }
 
+  void Row::clear(void)
+  {
+    _values.clear();
+  }
+
   bool Row::set(const std::string &key, const std::string &value) 
   {
     std::vector<std::string>::const_iterator it;
@@ -1,354 +1,1988 @@
-//============================================================================
-// Name        : HashTable.cpp
-// Author      : Your Name
-// Version     : 1.0
-// Copyright   : Copyright  2023 SNHU COCE
-// Description : Lab 4-2 Hash Table
-//============================================================================
-
-#include <algorithm>
-#include <climits>
-#include <iostream>
-#include <string> // atoi
-#include <time.h>
-
-#include "CSVparser.hpp"
-
-using namespace std;
-
-//============================================================================
-// Global definitions visible to all methods and classes
-//============================================================================
-
-const unsigned int DEFAULT_SIZE = 179;
-
-// forward declarations
-double strToDouble(string str, char ch);
-
-// define a structure to hold bid information
-struct Bid {
-    string bidId; // unique identifier
-    string title;
-    string fund;
-    double amount;
-    Bid() {
-        amount = 0.0;
-    }
-};
-
-//============================================================================
-// Hash Table class definition
-//============================================================================
-
-/**
- * Define a class containing data members and methods to
- * implement a hash table with chaining.
- */
-class HashTable {
-
-private:
-    // Define structures to hold bids
-    struct Node {
-        Bid bid;
-        unsigned int key;
-        Node *next;
-
-        // default constructor
-        Node() {
-            key = UINT_MAX;
-            next = nullptr;
-        }
-
-        // initialize with a bid
-        Node(Bid aBid) : Node() {
-            bid = aBid;
-        }
-
-        // initialize with a bid and a key
-        Node(Bid aBid, unsigned int aKey) : Node(aBid) {
-            key = aKey;
-        }
-    };
-
-    vector<Node> nodes;
-
-    unsigned int tableSize = DEFAULT_SIZE;
-
-    unsigned int hash(int key);
-
-public:
-    HashTable();
-    HashTable(unsigned int size);
-    virtual ~HashTable();
-    void Insert(Bid bid);
-    void PrintAll();
-    void Remove(string bidId);
-    Bid Search(string bidId);
-    size_t Size();
-};
-
-/**
- * Default constructor
- */
-HashTable::HashTable() {
-    // FIXME (1): Initialize the structures used to hold bids
-    
-    // Initalize node structure by resizing tableSize
-}
-
-/**
- * Constructor for specifying size of the table
- * Use to improve efficiency of hashing algorithm
- * by reducing collisions without wasting memory.
- */
-HashTable::HashTable(unsigned int size) {
-    // invoke local tableSize to size with this->
-    // resize nodes size
-}
-
-
-/**
- * Destructor
- */
-HashTable::~HashTable() {
-    // FIXME (2): Implement logic to free storage when class is destroyed
-    
-    // erase nodes beginning
-}
-
-/**
- * Calculate the hash value of a given key.
- * Note that key is specifically defined as
- * unsigned int to prevent undefined results
- * of a negative list index.
- *
- * @param key The key to hash
- * @return The calculated hash
- */
-unsigned int HashTable::hash(int key) {
-    // FIXME (3): Implement logic to calculate a hash value
-    // return key tableSize
-}
-
-/**
- * Insert a bid
- *
- * @param bid The bid to insert
- */
-void HashTable::Insert(Bid bid) {
-    // FIXME (4): Implement logic to insert a bid
-    // create the key for the given bid
-    // retrieve node using key
-    // if no entry found for the key
-        // assign this node to the key position
-    // else if node is not used
-         // assing old node key to UNIT_MAX, set to key, set old node to bid and old node next to null pointer
-    // else find the next open node
-            // add new newNode to end
-}
-
-/**
- * Print all bids
- */
-void HashTable::PrintAll() {
-    // FIXME (5): Implement logic to print all bids
-    // for node begin to end iterate
-    //   if key not equal to UINT_MAx
-            // output key, bidID, title, amount and fund
-            // node is equal to next iter
-            // while node not equal to nullptr
-               // output key, bidID, title, amount and fund
-               // node is equal to next node
-
-}
-
-/**
- * Remove a bid
- *
- * @param bidId The bid id to search for
- */
-void HashTable::Remove(string bidId) {
-    // FIXME (6): Implement logic to remove a bid
-    // set key equal to hash atoi bidID cstring
-    // erase node begin and key
-}
-
-/**
- * Search for the specified bidId
- *
- * @param bidId The bid id to search for
- */
-Bid HashTable::Search(string bidId) {
-    Bid bid;
-
-    // FIXME (7): Implement logic to search for and return a bid
-
-    // create the key for the given bid
-    // if entry found for the key
-         //return node bid
-
-    // if no entry found for the key
-      // return bid
-    // while node not equal to nullptr
-        // if the current node matches, return it
-        //node is equal to next node
-
-    return bid;
-}
-
-//============================================================================
-// Static methods used for testing
-//============================================================================
-
-/**
- * Display the bid information to the console (std::out)
- *
- * @param bid struct containing the bid info
- */
-void displayBid(Bid bid) {
-    cout << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
-            << bid.fund << endl;
-    return;
-}
-
-/**
- * Load a CSV file containing bids into a container
- *
- * @param csvPath the path to the CSV file to load
- * @return a container holding all the bids read
- */
-void loadBids(string csvPath, HashTable* hashTable) {
-    cout << "Loading CSV file " << csvPath << endl;
-
-    // initialize the CSV Parser using the given path
-    csv::Parser file = csv::Parser(csvPath);
-
-    // read and display header row - optional
-    vector<string> header = file.getHeader();
-    for (auto const& c : header) {
-        cout << c << " | ";
-    }
-    cout << "" << endl;
-
-    try {
-        // loop to read rows of a CSV file
-        for (unsigned int i = 0; i < file.rowCount(); i++) {
-
-            // Create a data structure and add to the collection of bids
-            Bid bid;
-            bid.bidId = file[i][1];
-            bid.title = file[i][0];
-            bid.fund = file[i][8];
-            bid.amount = strToDouble(file[i][4], '$');
-
-            //cout << "Item: " << bid.title << ", Fund: " << bid.fund << ", Amount: " << bid.amount << endl;
-
-            // push this bid to the end
-            hashTable->Insert(bid);
-        }
-    } catch (csv::Error &e) {
-        std::cerr << e.what() << std::endl;
-    }
-}
-
-/**
- * Simple C function to convert a string to a double
- * after stripping out unwanted char
- *
- * credit: http://stackoverflow.com/a/24875936
- *
- * @param ch The character to strip out
- */
-double strToDouble(string str, char ch) {
-    str.erase(remove(str.begin(), str.end(), ch), str.end());
-    return atof(str.c_str());
-}
-
-/**
- * The one and only main() method
- */
-int main(int argc, char* argv[]) {
-
-    // process command line arguments
-    string csvPath, bidKey;
-    switch (argc) {
-    case 2:
-        csvPath = argv[1];
-        bidKey = "98223";
-        break;
-    case 3:
-        csvPath = argv[1];
-        bidKey = argv[2];
-        break;
-    default:
-        csvPath = "eBid_Monthly_Sales.csv";
-        bidKey = "98223";
-    }
-
-    // Define a timer variable
-    clock_t ticks;
-
-    // Define a hash table to hold all the bids
-    HashTable* bidTable;
-
-    Bid bid;
-    bidTable = new HashTable();
-    
-    int choice = 0;
-    while (choice != 9) {
-        cout << "Menu:" << endl;
-        cout << "  1. Load Bids" << endl;
-        cout << "  2. Display All Bids" << endl;
-        cout << "  3. Find Bid" << endl;
-        cout << "  4. Remove Bid" << endl;
-        cout << "  9. Exit" << endl;
-        cout << "Enter choice: ";
-        cin >> choice;
-
-        switch (choice) {
-
-        case 1:
-            
-            // Initialize a timer variable before loading bids
-            ticks = clock();
-
-            // Complete the method call to load the bids
-            loadBids(csvPath, bidTable);
-
-            // Calculate elapsed time and display result
-            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
-            cout << "time: " << ticks << " clock ticks" << endl;
-            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
-            break;
-
-        case 2:
-            bidTable->PrintAll();
-            break;
-
-        case 3:
-            ticks = clock();
-
-            bid = bidTable->Search(bidKey);
-
-            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
-
-            if (!bid.bidId.empty()) {
-                displayBid(bid);
-            } else {
-                cout << "Bid Id " << bidKey << " not found." << endl;
-            }
-
-            cout << "time: " << ticks << " clock ticks" << endl;
-            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
-            break;
-
-        case 4:
-            bidTable->Remove(bidKey);
-            break;
-        }
-    }
-
-    cout << "Good bye." << endl;
-
-    return 0;
-}
+//============================================================================
+// Name        : HashTable.cpp
+// Author      : Your Name
+// Version     : 1.0
+// Copyright   : Copyright  2023 SNHU COCE
+// Description : Lab 4-2 Hash Table
+//============================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <time.h>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h> // _mm_prefetch
+#endif
+
+#include "BidSnapshot.hpp"
+#include "CSVparser.hpp"
+#include "NodePool.hpp"
+
+using namespace std;
+
+//============================================================================
+// Global definitions visible to all methods and classes
+//============================================================================
+
+const unsigned int DEFAULT_SIZE = 179;
+
+// number of keys SearchBatch hashes and prefetches before resolving them
+const size_t SEARCH_BATCH = 16;
+
+/**
+ * Hint the CPU to start loading the cache line holding p,
+ * a no-op where no prefetch instruction is available
+ */
+inline void prefetch(const void* p) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#elif defined(__GNUC__)
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+}
+
+// define a structure to hold bid information
+struct Bid {
+    string bidId; // unique identifier
+    string title;
+    csv::Symbol fund; // interned, only a few distinct funds
+    long long amount; // winning bid in cents
+    Bid() {
+        amount = 0;
+    }
+};
+
+//============================================================================
+// Allocation counting, lets the benchmark show lookups don't allocate
+//============================================================================
+
+// Counting replaces the global operator new for the whole program,
+// so it is only built in when HASHTABLE_COUNT_ALLOCATIONS is defined,
+// as the Benchmark configuration of the project does
+#ifdef HASHTABLE_COUNT_ALLOCATIONS
+const bool COUNTS_ALLOCATIONS = true;
+
+atomic<size_t> allocations(0);
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size != 0 ? size : 1)) {
+        return p;
+    }
+    throw bad_alloc();
+}
+
+// kept out of line: GCC would otherwise see free() inlined on
+// pointers it takes for the library operator new's and warn
+#if defined(__GNUC__)
+#define OUT_OF_LINE __attribute__((noinline))
+#else
+#define OUT_OF_LINE
+#endif
+
+OUT_OF_LINE void operator delete(void* p) noexcept {
+    free(p);
+}
+
+OUT_OF_LINE void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+#else
+const bool COUNTS_ALLOCATIONS = false;
+#endif
+
+/**
+ * Heap allocations made so far, always 0 unless
+ * HASHTABLE_COUNT_ALLOCATIONS is defined
+ */
+size_t allocationCount() {
+#ifdef HASHTABLE_COUNT_ALLOCATIONS
+    return allocations.load();
+#else
+    return 0;
+#endif
+}
+
+//============================================================================
+// Hash functions
+//============================================================================
+
+/**
+ * Hash the bytes of a bid id with XXH64 (seed 0), so every
+ * character counts and sequential ids don't cluster
+ */
+struct BidHash {
+    unsigned long long operator()(string_view bidId) const;
+};
+
+/**
+ * The original lab scheme: the numeric value of the bid id.
+ * Non numeric ids all map to 0; kept to compare distributions.
+ */
+struct AtoiHash {
+    unsigned long long operator()(string_view bidId) const {
+        // atoi() needs a terminated string, read the leading digits instead
+        unsigned int value = 0;
+        for (char c : bidId) {
+            if (c < '0' || c > '9') {
+                break;
+            }
+            value = value * 10 + (c - '0');
+        }
+        return value;
+    }
+};
+
+namespace {
+    const unsigned long long PRIME1 = 11400714785074694791ULL;
+    const unsigned long long PRIME2 = 14029467366897019727ULL;
+    const unsigned long long PRIME3 = 1609587929392839161ULL;
+    const unsigned long long PRIME4 = 9650029242287828579ULL;
+    const unsigned long long PRIME5 = 2870177450012600261ULL;
+
+    inline unsigned long long rotl(unsigned long long x, int r) {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    inline unsigned long long read64(const char* p) {
+        unsigned long long v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline unsigned int read32(const char* p) {
+        unsigned int v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline unsigned long long round64(unsigned long long acc, unsigned long long input) {
+        acc += input * PRIME2;
+        return rotl(acc, 31) * PRIME1;
+    }
+
+    inline unsigned long long merge64(unsigned long long acc, unsigned long long val) {
+        acc ^= round64(0, val);
+        return acc * PRIME1 + PRIME4;
+    }
+}
+
+unsigned long long BidHash::operator()(string_view bidId) const {
+    const char* p = bidId.data();
+    const char* end = p + bidId.size();
+    unsigned long long h;
+
+    if (bidId.size() >= 32) {
+        unsigned long long v1 = PRIME1 + PRIME2;
+        unsigned long long v2 = PRIME2;
+        unsigned long long v3 = 0;
+        unsigned long long v4 = 0 - PRIME1;
+        for (; end - p >= 32; p += 32) {
+            v1 = round64(v1, read64(p));
+            v2 = round64(v2, read64(p + 8));
+            v3 = round64(v3, read64(p + 16));
+            v4 = round64(v4, read64(p + 24));
+        }
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = merge64(h, v1);
+        h = merge64(h, v2);
+        h = merge64(h, v3);
+        h = merge64(h, v4);
+    } else {
+        h = PRIME5;
+    }
+    h += bidId.size();
+
+    for (; end - p >= 8; p += 8) {
+        h ^= round64(0, read64(p));
+        h = rotl(h, 27) * PRIME1 + PRIME4;
+    }
+    if (end - p >= 4) {
+        h ^= read32(p) * PRIME1;
+        h = rotl(h, 23) * PRIME2 + PRIME3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        h ^= static_cast<unsigned char>(*p) * PRIME5;
+        h = rotl(h, 11) * PRIME1;
+    }
+
+    // final avalanche
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+/**
+ * Print one line per histogram bucket with a bar scaled
+ * to the largest bucket, values past HISTOGRAM_ROWS are
+ * summed into a last "N+" line
+ *
+ * @param label what the histogram counts
+ * @param histogram number of entries for each value
+ */
+void printHistogram(const string& label, vector<size_t> histogram) {
+    const size_t HISTOGRAM_ROWS = 16;
+    bool tail = histogram.size() > HISTOGRAM_ROWS;
+    if (tail) {
+        for (size_t i = HISTOGRAM_ROWS; i < histogram.size(); ++i) {
+            histogram[HISTOGRAM_ROWS - 1] += histogram[i];
+        }
+        histogram.resize(HISTOGRAM_ROWS);
+    }
+
+    size_t largest = 1;
+    for (size_t n : histogram) {
+        largest = max(largest, n);
+    }
+
+    for (size_t i = 0; i < histogram.size(); ++i) {
+        if (histogram[i] == 0) {
+            continue;
+        }
+        bool last = tail && i + 1 == histogram.size();
+        cout << "  " << label << " " << i << (last ? "+" : "") << ": " << histogram[i] << " "
+             << string(histogram[i] * 40 / largest, '#') << endl;
+    }
+}
+
+//============================================================================
+// Hash Table class definition
+//============================================================================
+
+/**
+ * Define a class containing data members and methods to
+ * implement a hash table with chaining, bids are spread over
+ * the buckets by the Hasher function object.
+ *
+ * The table grows to the next prime past twice its size once it
+ * holds more bids than buckets. Growing is incremental: the old
+ * buckets are kept next to the new ones and every Insert or Remove
+ * moves a couple of them over, so no single call pays for a full
+ * rehash. Lookups check the old bucket until it has been moved.
+ *
+ * Chained nodes come from the Allocator (see NodePool.hpp), an
+ * arena by default so loading makes few allocations and the
+ * destructor sweeps whole chunks instead of walking the chains.
+ * The bids' strings are still freed one by one.
+ */
+template <typename Hasher = BidHash, template <typename> class Allocator = pool::Arena>
+class HashTable {
+
+private:
+    // Define structures to hold bids
+    struct Node {
+        Bid bid;
+        unsigned int key;
+        Node *next;
+
+        // default constructor
+        Node() {
+            key = UINT_MAX;
+            next = nullptr;
+        }
+
+        // initialize with a bid
+        Node(Bid aBid) : Node() {
+            bid = aBid;
+        }
+
+        // initialize with a bid and a key
+        Node(Bid aBid, unsigned int aKey) : Node(aBid) {
+            key = aKey;
+        }
+    };
+
+    vector<Node> nodes;
+
+    unsigned int tableSize = DEFAULT_SIZE;
+
+    size_t count = 0;
+
+    // buckets still waiting to be moved while growing
+    vector<Node> oldNodes;
+    unsigned int oldSize = 0;
+    unsigned int migrated = 0;
+
+    Hasher hasher;
+
+    // chained nodes, the bucket heads live in the arrays above
+    Allocator<Node> nodeAllocator;
+
+    unsigned int hash(string_view bidId) const;
+    const vector<Node>& bucket(unsigned long long h, unsigned int& key) const;
+    const vector<Node>& bucket(string_view bidId, unsigned int& key) const;
+    vector<Node>& bucket(string_view bidId, unsigned int& key);
+    static const Bid* find(const vector<Node>& table, unsigned int key, string_view bidId);
+    bool place(vector<Node>& table, unsigned int key, const Bid& bid);
+    void grow(unsigned int size);
+    void migrate(unsigned int buckets);
+    void freeChains(vector<Node>& table);
+    static unsigned int nextPrime(unsigned int n);
+
+public:
+    HashTable();
+    HashTable(unsigned int size);
+    virtual ~HashTable();
+    void Insert(Bid bid);
+    void PrintAll();
+    void Remove(string_view bidId);
+    const Bid* Search(string_view bidId) const;
+    void SearchBatch(const vector<string_view>& bidIds, vector<const Bid*>& results) const;
+    size_t Size();
+    void reserve(size_t n);
+    void PrintDistribution();
+};
+
+/**
+ * Default constructor
+ */
+template <typename Hasher, template <typename> class Allocator>
+HashTable<Hasher, Allocator>::HashTable() {
+    // Initalize node structure by resizing tableSize
+    nodes.resize(tableSize);
+}
+
+/**
+ * Constructor for specifying size of the table
+ * Use to improve efficiency of hashing algorithm
+ * by reducing collisions without wasting memory.
+ */
+template <typename Hasher, template <typename> class Allocator>
+HashTable<Hasher, Allocator>::HashTable(unsigned int size) {
+    this->tableSize = size > 0 ? size : 1;
+    nodes.resize(tableSize);
+}
+
+
+/**
+ * Destructor
+ */
+template <typename Hasher, template <typename> class Allocator>
+HashTable<Hasher, Allocator>::~HashTable() {
+    // an arena frees the chained nodes all at once
+    if (!Allocator<Node>::RELEASES_ALL) {
+        freeChains(nodes);
+        freeChains(oldNodes);
+    }
+}
+
+/**
+ * Free the chained nodes of a bucket array, the bucket
+ * heads live in the array itself
+ */
+template <typename Hasher, template <typename> class Allocator>
+void HashTable<Hasher, Allocator>::freeChains(vector<Node>& table) {
+    for (unsigned int i = 0; i < table.size(); ++i) {
+        Node* node = table[i].next;
+        while (node != nullptr) {
+            Node* temp = node;
+            node = node->next;
+            nodeAllocator.destroy(temp);
+        }
+    }
+    table.erase(table.begin(), table.end());
+}
+
+/**
+ * Smallest prime greater or equal to n
+ */
+template <typename Hasher, template <typename> class Allocator>
+unsigned int HashTable<Hasher, Allocator>::nextPrime(unsigned int n) {
+    if (n <= 2) {
+        return 2;
+    }
+    for (n |= 1; ; n += 2) {
+        bool prime = true;
+        for (unsigned int d = 3; d * d <= n; d += 2) {
+            if (n % d == 0) {
+                prime = false;
+                break;
+            }
+        }
+        if (prime) {
+            return n;
+        }
+    }
+}
+
+/**
+ * Calculate the bucket of a given bid id.
+ * Note that the result is specifically defined as
+ * unsigned int to prevent undefined results
+ * of a negative list index.
+ *
+ * @param bidId The bid id to hash
+ * @return The calculated hash
+ */
+template <typename Hasher, template <typename> class Allocator>
+unsigned int HashTable<Hasher, Allocator>::hash(string_view bidId) const {
+    return static_cast<unsigned int>(hasher(bidId) % tableSize);
+}
+
+/**
+ * Find the bucket a bid id belongs to: its old bucket
+ * until that one has been migrated, else the new one
+ *
+ * @param h The Hasher value of the bid id
+ * @param key Set to the bucket index
+ * @return the bucket array holding the bucket
+ */
+template <typename Hasher, template <typename> class Allocator>
+const vector<typename HashTable<Hasher, Allocator>::Node>& HashTable<Hasher, Allocator>::bucket(unsigned long long h, unsigned int& key) const {
+    if (oldSize != 0) {
+        key = static_cast<unsigned int>(h % oldSize);
+        if (key >= migrated) {
+            return oldNodes;
+        }
+    }
+    key = static_cast<unsigned int>(h % tableSize);
+    return nodes;
+}
+
+template <typename Hasher, template <typename> class Allocator>
+const vector<typename HashTable<Hasher, Allocator>::Node>& HashTable<Hasher, Allocator>::bucket(string_view bidId, unsigned int& key) const {
+    return bucket(hasher(bidId), key);
+}
+
+template <typename Hasher, template <typename> class Allocator>
+vector<typename HashTable<Hasher, Allocator>::Node>& HashTable<Hasher, Allocator>::bucket(string_view bidId, unsigned int& key) {
+    return const_cast<vector<Node>&>(static_cast<const HashTable*>(this)->bucket(bidId, key));
+}
+
+/**
+ * Put a bid in a bucket array, replacing a bid with the same id
+ *
+ * @return false when a bid was replaced rather than added
+ */
+template <typename Hasher, template <typename> class Allocator>
+bool HashTable<Hasher, Allocator>::place(vector<Node>& table, unsigned int key, const Bid& bid) {
+    // retrieve node using key
+    Node* node = &(table.at(key));
+
+    // if the bucket is unused, the bid goes in its head node
+    if (node->key == UINT_MAX) {
+        node->key = key;
+        node->bid = bid;
+        node->next = nullptr;
+        return true;
+    }
+
+    // else walk the chain, a bid with the same id is replaced,
+    // otherwise a new node is added at its end
+    while (node->bid.bidId != bid.bidId) {
+        if (node->next == nullptr) {
+            node->next = nodeAllocator.create(bid, key);
+            return true;
+        }
+        node = node->next;
+    }
+    node->bid = bid;
+    return false;
+}
+
+/**
+ * Start growing to a new bucket array, the current one
+ * becomes the old one and is drained by migrate()
+ */
+template <typename Hasher, template <typename> class Allocator>
+void HashTable<Hasher, Allocator>::grow(unsigned int size) {
+    // an unfinished migration is completed first
+    migrate(oldSize);
+
+    oldNodes.swap(nodes);
+    oldSize = tableSize;
+    migrated = 0;
+
+    tableSize = nextPrime(size);
+    nodes.assign(tableSize, Node());
+}
+
+/**
+ * Move up to the given number of old buckets to the new array
+ */
+template <typename Hasher, template <typename> class Allocator>
+void HashTable<Hasher, Allocator>::migrate(unsigned int buckets) {
+    for (; buckets > 0 && migrated < oldSize; --buckets, ++migrated) {
+        Node* head = &oldNodes[migrated];
+        if (head->key == UINT_MAX) {
+            continue;
+        }
+        place(nodes, hash(head->bid.bidId), head->bid);
+
+        Node* node = head->next;
+        while (node != nullptr) {
+            Node* temp = node;
+            place(nodes, hash(node->bid.bidId), node->bid);
+            node = node->next;
+            nodeAllocator.destroy(temp);
+        }
+        head->next = nullptr;
+    }
+
+    if (oldSize != 0 && migrated == oldSize) {
+        vector<Node>().swap(oldNodes);
+        oldSize = 0;
+        migrated = 0;
+    }
+}
+
+/**
+ * Make room for n bids without growing again,
+ * used before a bulk load
+ *
+ * @param n The number of bids expected
+ */
+template <typename Hasher, template <typename> class Allocator>
+void HashTable<Hasher, Allocator>::reserve(size_t n) {
+    if (n > tableSize) {
+        grow(static_cast<unsigned int>(n));
+        migrate(oldSize);
+    }
+}
+
+/**
+ * Insert a bid, replacing a bid with the same id
+ *
+ * @param bid The bid to insert
+ */
+template <typename Hasher, template <typename> class Allocator>
+void HashTable<Hasher, Allocator>::Insert(Bid bid) {
+    migrate(2);
+
+    // keep the load factor at or under one bid per bucket
+    if (count + 1 > tableSize) {
+        grow(tableSize * 2 + 1);
+    }
+
+    // create the key for the given bid
+    unsigned int key;
+    vector<Node>& table = bucket(bid.bidId, key);
+    if (place(table, key, bid)) {
+        ++count;
+    }
+}
+
+/**
+ * Print all bids
+ */
+template <typename Hasher, template <typename> class Allocator>
+void HashTable<Hasher, Allocator>::PrintAll() {
+    const vector<Node>* tables[] = { &oldNodes, &nodes };
+
+    for (const vector<Node>* table : tables) {
+        for (unsigned int i = 0; i < table->size(); ++i) {
+            if ((*table)[i].key == UINT_MAX) {
+                continue;
+            }
+
+            // output key, bidID, title, amount and fund for the whole chain
+            for (const Node* node = &(*table)[i]; node != nullptr; node = node->next) {
+                cout << "Key " << node->key << ": " << node->bid.bidId << " | "
+                     << node->bid.title << " | " << node->bid.amount / 100.0 << " | "
+                     << node->bid.fund << endl;
+            }
+        }
+    }
+}
+
+/**
+ * Remove a bid
+ *
+ * @param bidId The bid id to search for
+ */
+template <typename Hasher, template <typename> class Allocator>
+void HashTable<Hasher, Allocator>::Remove(string_view bidId) {
+    migrate(2);
+
+    unsigned int key;
+    Node* head = &(bucket(bidId, key).at(key));
+
+    if (head->key == UINT_MAX) {
+        return;
+    }
+
+    // the head node is embedded: pull the next node into it
+    if (head->bid.bidId == bidId) {
+        Node* next = head->next;
+        if (next != nullptr) {
+            head->bid = next->bid;
+            head->next = next->next;
+            nodeAllocator.destroy(next);
+        } else {
+            head->key = UINT_MAX;
+            head->bid = Bid();
+        }
+        --count;
+        return;
+    }
+
+    // otherwise unlink the matching chained node
+    for (Node* prev = head; prev->next != nullptr; prev = prev->next) {
+        if (prev->next->bid.bidId == bidId) {
+            Node* temp = prev->next;
+            prev->next = temp->next;
+            nodeAllocator.destroy(temp);
+            --count;
+            return;
+        }
+    }
+}
+
+/**
+ * Search for the specified bidId, without copying the key
+ * or the bid
+ *
+ * @param bidId The bid id to search for
+ * @return the bid in the table, or nullptr when absent; it
+ *         stays valid until the table is next modified
+ */
+template <typename Hasher, template <typename> class Allocator>
+const Bid* HashTable<Hasher, Allocator>::Search(string_view bidId) const {
+    // find the bucket for the given bid
+    unsigned int key;
+    const vector<Node>& table = bucket(bidId, key);
+    return find(table, key, bidId);
+}
+
+/**
+ * Search for many bid ids at once. Each group of SEARCH_BATCH
+ * keys is hashed and has its buckets prefetched before any of
+ * them is compared, so the cache misses overlap instead of
+ * being paid one after the other.
+ *
+ * @param bidIds The bid ids to search for
+ * @param results Set to one bid pointer per id, nullptr when absent
+ */
+template <typename Hasher, template <typename> class Allocator>
+void HashTable<Hasher, Allocator>::SearchBatch(const vector<string_view>& bidIds, vector<const Bid*>& results) const {
+    results.resize(bidIds.size());
+
+    const vector<Node>* tables[SEARCH_BATCH];
+    unsigned int keys[SEARCH_BATCH];
+
+    for (size_t first = 0; first < bidIds.size(); first += SEARCH_BATCH) {
+        size_t n = min(SEARCH_BATCH, bidIds.size() - first);
+
+        for (size_t i = 0; i < n; ++i) {
+            tables[i] = &bucket(hasher(bidIds[first + i]), keys[i]);
+            prefetch(&(*tables[i])[keys[i]]);
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            results[first + i] = find(*tables[i], keys[i], bidIds[first + i]);
+        }
+    }
+}
+
+/**
+ * Walk the chain of one bucket looking for a bid id
+ *
+ * @return the bid, or nullptr when absent
+ */
+template <typename Hasher, template <typename> class Allocator>
+const Bid* HashTable<Hasher, Allocator>::find(const vector<Node>& table, unsigned int key, string_view bidId) {
+    const Node* node = &table[key];
+
+    // if no entry found for the key
+    if (node->key == UINT_MAX) {
+        return nullptr;
+    }
+
+    // walk the chain, if the current node matches, return it
+    while (node != nullptr) {
+        if (node->bid.bidId == bidId) {
+            return &node->bid;
+        }
+        node = node->next;
+    }
+
+    return nullptr;
+}
+
+/**
+ * Returns the number of bids in the table
+ */
+template <typename Hasher, template <typename> class Allocator>
+size_t HashTable<Hasher, Allocator>::Size() {
+    return count;
+}
+
+/**
+ * Print a histogram of the chain lengths, to check
+ * how evenly the hasher spreads the bid ids
+ */
+template <typename Hasher, template <typename> class Allocator>
+void HashTable<Hasher, Allocator>::PrintDistribution() {
+    const vector<Node>* tables[] = { &oldNodes, &nodes };
+    vector<size_t> histogram;
+
+    for (const vector<Node>* table : tables) {
+        for (unsigned int i = 0; i < table->size(); ++i) {
+            size_t length = 0;
+            if ((*table)[i].key != UINT_MAX) {
+                for (const Node* node = &(*table)[i]; node != nullptr; node = node->next) {
+                    ++length;
+                }
+            }
+            if (length >= histogram.size()) {
+                histogram.resize(length + 1);
+            }
+            ++histogram[length];
+        }
+    }
+
+    cout << count << " bids in " << tableSize << " buckets, load factor "
+         << count * 1.0 / tableSize << endl;
+    printHistogram("chain length", histogram);
+}
+
+//============================================================================
+// Flat Hash Table class definition
+//============================================================================
+
+/**
+ * Define a class with the same methods as HashTable but backed
+ * by open addressing (Robin Hood linear probing).
+ *
+ * Slots only hold a hash fingerprint and the index of the bid in
+ * a dense payload array, so a probe scans one contiguous array of
+ * 8 byte slots and only touches a Bid when the fingerprints match.
+ * Removal shifts the following entries back instead of leaving
+ * tombstones, so probe sequences never get longer over time.
+ */
+template <typename Hasher = BidHash>
+class FlatHashTable {
+
+private:
+    struct Slot {
+        unsigned int hash;   // 0 marks an empty slot
+        unsigned int index;  // position of the bid in bids
+    };
+
+    vector<Slot> slots;
+    vector<Bid> bids;
+    unsigned int mask;
+    Hasher hasher;
+
+    unsigned int hash(string_view bidId) const;
+    unsigned int distance(unsigned int pos) const;
+    unsigned int find(string_view bidId) const;
+    unsigned int find(string_view bidId, unsigned int h) const;
+    unsigned int probe(unsigned int h) const;
+    void place(Slot slot);
+    void grow();
+    void grow(size_t capacity);
+
+public:
+    FlatHashTable();
+    FlatHashTable(unsigned int size);
+    virtual ~FlatHashTable();
+    void Insert(Bid bid);
+    void PrintAll();
+    void Remove(string_view bidId);
+    const Bid* Search(string_view bidId) const;
+    void SearchBatch(const vector<string_view>& bidIds, vector<const Bid*>& results) const;
+    size_t Size();
+    void reserve(size_t n);
+    void PrintDistribution();
+};
+
+/**
+ * Default constructor
+ */
+template <typename Hasher>
+FlatHashTable<Hasher>::FlatHashTable() : FlatHashTable(DEFAULT_SIZE) {
+}
+
+/**
+ * Constructor for specifying the expected number of bids,
+ * rounded up to a power of two number of slots
+ */
+template <typename Hasher>
+FlatHashTable<Hasher>::FlatHashTable(unsigned int size) {
+    unsigned int capacity = 16;
+    while (capacity < size) {
+        capacity <<= 1;
+    }
+    slots.assign(capacity, Slot{ 0, 0 });
+    mask = capacity - 1;
+}
+
+/**
+ * Destructor
+ */
+template <typename Hasher>
+FlatHashTable<Hasher>::~FlatHashTable() {
+}
+
+/**
+ * Calculate the hash value of a bid id, never 0.
+ * The low bits pick the home slot, the rest is kept
+ * in the slot as a fingerprint.
+ *
+ * @param bidId The bid id to hash
+ * @return The calculated hash
+ */
+template <typename Hasher>
+unsigned int FlatHashTable<Hasher>::hash(string_view bidId) const {
+    unsigned long long h = hasher(bidId);
+    // the top bit only marks the slot used, home slots come from the low bits
+    return static_cast<unsigned int>(h ^ (h >> 32)) | 0x80000000u;
+}
+
+/**
+ * How far the entry in a slot sits from its home slot
+ */
+template <typename Hasher>
+unsigned int FlatHashTable<Hasher>::distance(unsigned int pos) const {
+    return (pos - (slots[pos].hash & mask)) & mask;
+}
+
+/**
+ * Find the slot holding a bid id
+ *
+ * @return the slot position, or slots.size() when absent
+ */
+template <typename Hasher>
+unsigned int FlatHashTable<Hasher>::find(string_view bidId) const {
+    return find(bidId, hash(bidId));
+}
+
+template <typename Hasher>
+unsigned int FlatHashTable<Hasher>::find(string_view bidId, unsigned int h) const {
+    unsigned int pos = h & mask;
+
+    // Robin Hood invariant: stop once we are further than the resident
+    for (unsigned int dist = 0; slots[pos].hash != 0 && dist <= distance(pos); ++dist) {
+        if (slots[pos].hash == h && bids[slots[pos].index].bidId == bidId) {
+            return pos;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return slots.size();
+}
+
+/**
+ * Find the first slot whose fingerprint matches a hash,
+ * without looking at the bids
+ *
+ * @return the slot position, or slots.size() when none matches
+ */
+template <typename Hasher>
+unsigned int FlatHashTable<Hasher>::probe(unsigned int h) const {
+    unsigned int pos = h & mask;
+
+    for (unsigned int dist = 0; slots[pos].hash != 0 && dist <= distance(pos); ++dist) {
+        if (slots[pos].hash == h) {
+            return pos;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return slots.size();
+}
+
+/**
+ * Put a slot in the table, displacing entries closer to their home
+ */
+template <typename Hasher>
+void FlatHashTable<Hasher>::place(Slot slot) {
+    unsigned int pos = slot.hash & mask;
+    unsigned int dist = 0;
+
+    while (slots[pos].hash != 0) {
+        unsigned int resident = distance(pos);
+        if (resident < dist) {
+            swap(slot, slots[pos]);
+            dist = resident;
+        }
+        pos = (pos + 1) & mask;
+        ++dist;
+    }
+    slots[pos] = slot;
+}
+
+/**
+ * Double the number of slots and re-place every entry
+ */
+template <typename Hasher>
+void FlatHashTable<Hasher>::grow() {
+    grow(slots.size() * 2);
+}
+
+/**
+ * Re-place every entry in a new array of the given
+ * power of two number of slots
+ */
+template <typename Hasher>
+void FlatHashTable<Hasher>::grow(size_t capacity) {
+    vector<Slot> old(capacity, Slot{ 0, 0 });
+    old.swap(slots);
+    mask = slots.size() - 1;
+    for (auto const& slot : old) {
+        if (slot.hash != 0) {
+            place(slot);
+        }
+    }
+}
+
+/**
+ * Make room for n bids without growing again,
+ * used before a bulk load
+ *
+ * @param n The number of bids expected
+ */
+template <typename Hasher>
+void FlatHashTable<Hasher>::reserve(size_t n) {
+    size_t capacity = slots.size();
+    while (n * 8 > capacity * 7) {
+        capacity <<= 1;
+    }
+    if (capacity != slots.size()) {
+        grow(capacity);
+    }
+    bids.reserve(n);
+}
+
+/**
+ * Insert a bid, replacing a bid with the same id
+ *
+ * @param bid The bid to insert
+ */
+template <typename Hasher>
+void FlatHashTable<Hasher>::Insert(Bid bid) {
+    unsigned int pos = find(bid.bidId);
+    if (pos != slots.size()) {
+        bids[slots[pos].index] = bid;
+        return;
+    }
+
+    // keep the load factor under 7/8
+    if ((bids.size() + 1) * 8 > slots.size() * 7) {
+        grow();
+    }
+
+    bids.push_back(bid);
+    place(Slot{ hash(bid.bidId), static_cast<unsigned int>(bids.size() - 1) });
+}
+
+/**
+ * Print all bids
+ */
+template <typename Hasher>
+void FlatHashTable<Hasher>::PrintAll() {
+    for (unsigned int i = 0; i < slots.size(); ++i) {
+        if (slots[i].hash == 0) {
+            continue;
+        }
+        const Bid& bid = bids[slots[i].index];
+        cout << "Key " << i << ": " << bid.bidId << " | " << bid.title << " | "
+             << bid.amount / 100.0 << " | " << bid.fund << endl;
+    }
+}
+
+/**
+ * Remove a bid
+ *
+ * @param bidId The bid id to search for
+ */
+template <typename Hasher>
+void FlatHashTable<Hasher>::Remove(string_view bidId) {
+    unsigned int pos = find(bidId);
+    if (pos == slots.size()) {
+        return;
+    }
+
+    // keep bids dense: move the last bid into the hole
+    unsigned int index = slots[pos].index;
+    if (index != bids.size() - 1) {
+        unsigned int last = find(bids.back().bidId);
+        bids[index] = bids.back();
+        slots[last].index = index;
+    }
+    bids.pop_back();
+
+    // backward shift deletion
+    unsigned int next = (pos + 1) & mask;
+    while (slots[next].hash != 0 && distance(next) != 0) {
+        slots[pos] = slots[next];
+        pos = next;
+        next = (next + 1) & mask;
+    }
+    slots[pos] = Slot{ 0, 0 };
+}
+
+/**
+ * Search for the specified bidId, without copying the key
+ * or the bid
+ *
+ * @param bidId The bid id to search for
+ * @return the bid in the table, or nullptr when absent; it
+ *         stays valid until the table is next modified
+ */
+template <typename Hasher>
+const Bid* FlatHashTable<Hasher>::Search(string_view bidId) const {
+    unsigned int pos = find(bidId);
+    if (pos == slots.size()) {
+        return nullptr;
+    }
+    return &bids[slots[pos].index];
+}
+
+/**
+ * Search for many bid ids at once, in three passes over each
+ * group of SEARCH_BATCH keys: hash and prefetch the home slots,
+ * match fingerprints and prefetch the bids, then compare ids.
+ * Each pass only touches memory the previous one prefetched.
+ *
+ * @param bidIds The bid ids to search for
+ * @param results Set to one bid pointer per id, nullptr when absent
+ */
+template <typename Hasher>
+void FlatHashTable<Hasher>::SearchBatch(const vector<string_view>& bidIds, vector<const Bid*>& results) const {
+    results.resize(bidIds.size());
+
+    unsigned int hashes[SEARCH_BATCH];
+    unsigned int positions[SEARCH_BATCH];
+
+    for (size_t first = 0; first < bidIds.size(); first += SEARCH_BATCH) {
+        size_t n = min(SEARCH_BATCH, bidIds.size() - first);
+
+        for (size_t i = 0; i < n; ++i) {
+            hashes[i] = hash(bidIds[first + i]);
+            prefetch(&slots[hashes[i] & mask]);
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            positions[i] = probe(hashes[i]);
+            if (positions[i] != slots.size()) {
+                prefetch(&bids[slots[positions[i]].index]);
+            }
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            unsigned int pos = positions[i];
+            // a fingerprint collision falls back to the full probe
+            if (pos != slots.size() && bids[slots[pos].index].bidId != bidIds[first + i]) {
+                pos = find(bidIds[first + i], hashes[i]);
+            }
+            results[first + i] = pos != slots.size() ? &bids[slots[pos].index] : nullptr;
+        }
+    }
+}
+
+/**
+ * Returns the number of bids in the table
+ */
+template <typename Hasher>
+size_t FlatHashTable<Hasher>::Size() {
+    return bids.size();
+}
+
+/**
+ * Print a histogram of the probe distances, to check
+ * how evenly the hasher spreads the bid ids
+ */
+template <typename Hasher>
+void FlatHashTable<Hasher>::PrintDistribution() {
+    vector<size_t> histogram;
+
+    for (unsigned int i = 0; i < slots.size(); ++i) {
+        if (slots[i].hash == 0) {
+            continue;
+        }
+        unsigned int dist = distance(i);
+        if (dist >= histogram.size()) {
+            histogram.resize(dist + 1);
+        }
+        ++histogram[dist];
+    }
+
+    cout << bids.size() << " bids in " << slots.size() << " slots, load factor "
+         << bids.size() * 1.0 / slots.size() << endl;
+    printHistogram("probe distance", histogram);
+}
+
+//============================================================================
+// Concurrent Hash Table class definition
+//============================================================================
+
+/**
+ * Define a class with the HashTable methods that many threads can
+ * use at once. The bids are split over a fixed number of shards by
+ * the high bits of their hash, each shard being a HashTable guarded
+ * by its own reader/writer lock, so threads working on different
+ * shards never wait for each other and readers of one shard share
+ * its lock.
+ *
+ * Search copies the bid out while holding the lock: a pointer into
+ * a shard could be freed by a Remove on another thread as soon as
+ * the lock is released.
+ */
+template <typename Hasher = BidHash>
+class ConcurrentHashTable {
+
+private:
+    // one cache line per lock, so shards don't false share
+    struct alignas(64) Shard {
+        mutable shared_mutex lock;
+        HashTable<Hasher> table;
+    };
+
+    vector<Shard> shards;
+    unsigned int shift;
+    Hasher hasher;
+
+    Shard& shard(string_view bidId);
+    const Shard& shard(string_view bidId) const;
+
+public:
+    ConcurrentHashTable();
+    ConcurrentHashTable(unsigned int shardCount);
+    virtual ~ConcurrentHashTable();
+    void Insert(Bid bid);
+    void PrintAll();
+    void Remove(string_view bidId);
+    bool Search(string_view bidId, Bid& bid) const;
+    size_t Size();
+    void reserve(size_t n);
+    void PrintDistribution();
+};
+
+/**
+ * Default constructor, 64 shards
+ */
+template <typename Hasher>
+ConcurrentHashTable<Hasher>::ConcurrentHashTable() : ConcurrentHashTable(64) {
+}
+
+/**
+ * Constructor for specifying the number of shards,
+ * rounded up to a power of two
+ */
+template <typename Hasher>
+ConcurrentHashTable<Hasher>::ConcurrentHashTable(unsigned int shardCount) {
+    unsigned int count = 1;
+    shift = 64;
+    while (count < shardCount) {
+        count <<= 1;
+        --shift;
+    }
+    shards = vector<Shard>(count);
+}
+
+/**
+ * Destructor
+ */
+template <typename Hasher>
+ConcurrentHashTable<Hasher>::~ConcurrentHashTable() {
+}
+
+/**
+ * Find the shard of a bid id. The hash is spread with a
+ * multiply first so hashers with weak high bits, like
+ * AtoiHash, still use every shard.
+ */
+template <typename Hasher>
+typename ConcurrentHashTable<Hasher>::Shard& ConcurrentHashTable<Hasher>::shard(string_view bidId) {
+    return const_cast<Shard&>(static_cast<const ConcurrentHashTable*>(this)->shard(bidId));
+}
+
+template <typename Hasher>
+const typename ConcurrentHashTable<Hasher>::Shard& ConcurrentHashTable<Hasher>::shard(string_view bidId) const {
+    if (shift == 64) {
+        return shards[0];
+    }
+    return shards[(hasher(bidId) * PRIME1) >> shift];
+}
+
+/**
+ * Make room for n bids without growing again,
+ * used before a bulk load
+ *
+ * @param n The number of bids expected
+ */
+template <typename Hasher>
+void ConcurrentHashTable<Hasher>::reserve(size_t n) {
+    for (Shard& s : shards) {
+        unique_lock<shared_mutex> guard(s.lock);
+        // leave some slack, shards don't fill up evenly
+        s.table.reserve(n / shards.size() + n / shards.size() / 8 + 1);
+    }
+}
+
+/**
+ * Insert a bid, replacing a bid with the same id
+ *
+ * @param bid The bid to insert
+ */
+template <typename Hasher>
+void ConcurrentHashTable<Hasher>::Insert(Bid bid) {
+    Shard& s = shard(bid.bidId);
+    unique_lock<shared_mutex> guard(s.lock);
+    s.table.Insert(bid);
+}
+
+/**
+ * Print all bids, one shard at a time
+ */
+template <typename Hasher>
+void ConcurrentHashTable<Hasher>::PrintAll() {
+    for (Shard& s : shards) {
+        shared_lock<shared_mutex> guard(s.lock);
+        s.table.PrintAll();
+    }
+}
+
+/**
+ * Remove a bid
+ *
+ * @param bidId The bid id to search for
+ */
+template <typename Hasher>
+void ConcurrentHashTable<Hasher>::Remove(string_view bidId) {
+    Shard& s = shard(bidId);
+    unique_lock<shared_mutex> guard(s.lock);
+    s.table.Remove(bidId);
+}
+
+/**
+ * Search for the specified bidId
+ *
+ * @param bidId The bid id to search for
+ * @param bid Set to a copy of the bid when found
+ * @return whether the bid was found
+ */
+template <typename Hasher>
+bool ConcurrentHashTable<Hasher>::Search(string_view bidId, Bid& bid) const {
+    const Shard& s = shard(bidId);
+    shared_lock<shared_mutex> guard(s.lock);
+    const Bid* found = s.table.Search(bidId);
+    if (found == nullptr) {
+        return false;
+    }
+    bid = *found;
+    return true;
+}
+
+/**
+ * Returns the number of bids in the table, which may
+ * already be stale when other threads are writing
+ */
+template <typename Hasher>
+size_t ConcurrentHashTable<Hasher>::Size() {
+    size_t count = 0;
+    for (Shard& s : shards) {
+        shared_lock<shared_mutex> guard(s.lock);
+        count += s.table.Size();
+    }
+    return count;
+}
+
+/**
+ * Print how many bids each shard holds
+ */
+template <typename Hasher>
+void ConcurrentHashTable<Hasher>::PrintDistribution() {
+    vector<size_t> histogram;
+    size_t count = 0;
+    for (Shard& s : shards) {
+        shared_lock<shared_mutex> guard(s.lock);
+        count += s.table.Size();
+        histogram.push_back(s.table.Size());
+    }
+
+    cout << count << " bids in " << shards.size() << " shards, smallest "
+         << *min_element(histogram.begin(), histogram.end()) << ", largest "
+         << *max_element(histogram.begin(), histogram.end()) << endl;
+}
+
+//============================================================================
+// Static methods used for testing
+//============================================================================
+
+/**
+ * Display the bid information to the console (std::out)
+ *
+ * @param bid struct containing the bid info
+ */
+void displayBid(const Bid& bid) {
+    cout << bid.bidId << ": " << bid.title << " | " << bid.amount / 100.0 << " | "
+            << bid.fund << endl;
+    return;
+}
+
+// CSV columns a bid is built from: title, id, winning bid and fund
+const csv::Columns BID_COLUMNS = { 0, 1, 4, 8 };
+
+/**
+ * Build a bid from the current row of a CSV cursor
+ * projected on BID_COLUMNS
+ *
+ * @param row cursor positioned on a data row
+ * @return Bid struct containing the bid info, empty when the
+ *         winning bid can't be read
+ */
+optional<Bid> parseBid(const csv::Cursor& row) {
+    Bid bid;
+    bid.bidId = row.unquote(1);
+    bid.title = row.unquote(0);
+    bid.fund = row.unquote(3);
+    if (!csv::toCents(row[2], bid.amount)) {
+        return nullopt;
+    }
+    return bid;
+}
+
+/**
+ * Parse the bids of a mapped CSV file on all cores, they come
+ * back in file order. Rows whose winning bid can't be read are
+ * skipped and counted.
+ *
+ * @param file the mapped CSV file
+ * @return the bids read
+ */
+vector<Bid> parseBids(const csv::MappedFile& file) {
+    vector<optional<Bid>> rows = csv::parallelLoad<optional<Bid>>(file, parseBid, BID_COLUMNS);
+
+    vector<Bid> bids;
+    bids.reserve(rows.size());
+    for (auto& row : rows) {
+        if (row) {
+            bids.push_back(move(*row));
+        }
+    }
+    if (bids.size() != rows.size()) {
+        cout << rows.size() - bids.size() << " rows skipped, their winning bid can't be read" << endl;
+    }
+    return bids;
+}
+
+/**
+ * Load bids from the binary snapshot of a CSV file
+ *
+ * @param csvPath the path to the CSV file the snapshot was made from
+ * @param bids vector receiving the bids
+ * @return true when an up to date snapshot was found
+ */
+bool loadSnapshot(string csvPath, vector<Bid>& bids) {
+    try {
+        snapshot::Reader snap(snapshot::pathFor(csvPath));
+        if (!snap.fresh(csvPath)) {
+            return false;
+        }
+
+        bids.reserve(snap.size());
+        for (unsigned int i = 0; i < snap.size(); ++i) {
+            Bid bid;
+            bid.bidId = snap.bidId(i);
+            bid.title = snap.title(i);
+            bid.fund = snap.fund(i);
+            bid.amount = snap.amount(i);
+            bids.push_back(bid);
+        }
+    } catch (snapshot::Error &e) {
+        bids.clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Save bids read from a CSV file to its binary snapshot
+ *
+ * @param csvPath the path to the CSV file the bids were read from
+ * @param bids the bids to save
+ */
+void saveSnapshot(string csvPath, const vector<Bid>& bids) {
+    snapshot::Writer writer;
+    try {
+        for (auto const& bid : bids) {
+            writer.add(bid.bidId, bid.title, bid.fund.str(), bid.amount);
+        }
+        writer.write(snapshot::pathFor(csvPath), csvPath);
+    } catch (snapshot::Error &e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+/**
+ * Read the bids of a CSV file, from its snapshot when up to date
+ *
+ * @param csvPath the path to the CSV file to load
+ * @return the bids in file order
+ */
+vector<Bid> readBids(string csvPath) {
+    vector<Bid> bids;
+
+    // reuse the binary snapshot while it matches the CSV file
+    if (loadSnapshot(csvPath, bids)) {
+        return bids;
+    }
+
+    try {
+        // map the CSV file and walk it without copying the rows
+        csv::MappedFile file(csvPath);
+        csv::Cursor header(file);
+
+        // read and display header row - optional
+        if (header.next()) {
+            for (unsigned int c = 0; c < header.size(); ++c) {
+                cout << header[c] << " | ";
+            }
+        }
+        cout << "" << endl;
+
+        // parse the rows on all cores, they come back in file order
+        bids = parseBids(file);
+        saveSnapshot(csvPath, bids);
+    } catch (csv::Error &e) {
+        std::cerr << e.what() << std::endl;
+    }
+    return bids;
+}
+
+/**
+ * Load a CSV file containing bids into a container
+ *
+ * @param csvPath the path to the CSV file to load
+ * @param hashTable the HashTable or FlatHashTable receiving the bids
+ */
+template <typename Table>
+void loadBids(string csvPath, Table* hashTable) {
+    cout << "Loading CSV file " << csvPath << endl;
+
+    vector<Bid> bids = readBids(csvPath);
+
+    // size the table once for the whole file
+    hashTable->reserve(hashTable->Size() + bids.size());
+
+    for (auto const& bid : bids) {
+        // push this bid to the end
+        hashTable->Insert(bid);
+    }
+}
+
+/**
+ * Look every key up in a table a number of times and print the
+ * average time and heap allocations of one lookup
+ *
+ * @param label name of the table
+ * @param copy copy each bid found out of the table, the way
+ *             Search used to return it
+ */
+template <typename Table>
+void timeLookups(const string& label, const Table& table, const vector<string>& keys,
+        unsigned int rounds, bool copy) {
+    size_t found = 0;
+    size_t lookups = keys.size() * rounds;
+
+    size_t allocated = allocationCount();
+    auto start = chrono::steady_clock::now();
+    for (unsigned int r = 0; r < rounds; ++r) {
+        for (auto const& key : keys) {
+            const Bid* bid = table.Search(key);
+            if (bid == nullptr) {
+                continue;
+            }
+            if (copy) {
+                Bid bidCopy = *bid;
+                found += !bidCopy.bidId.empty();
+            } else {
+                ++found;
+            }
+        }
+    }
+    chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+    allocated = allocationCount() - allocated;
+
+    cout << "  " << label << ": " << elapsed.count() / lookups << " ns/lookup";
+    if (COUNTS_ALLOCATIONS) {
+        cout << ", " << allocated * 1.0 / lookups << " allocations/lookup";
+    }
+    cout << endl;
+    if (found != lookups) {
+        cout << "  (" << lookups - found << " lookups missed)" << endl;
+    }
+}
+
+/**
+ * Look every key up in a table a number of times with
+ * SearchBatch and print the average time and heap
+ * allocations of one lookup
+ *
+ * @param label name of the table
+ */
+template <typename Table>
+void timeBatchLookups(const string& label, const Table& table, const vector<string>& keys,
+        unsigned int rounds) {
+    size_t found = 0;
+    size_t lookups = keys.size() * rounds;
+
+    vector<string_view> views(keys.begin(), keys.end());
+    vector<const Bid*> results;
+    results.reserve(views.size());
+
+    size_t allocated = allocationCount();
+    auto start = chrono::steady_clock::now();
+    for (unsigned int r = 0; r < rounds; ++r) {
+        table.SearchBatch(views, results);
+        for (const Bid* bid : results) {
+            found += bid != nullptr;
+        }
+    }
+    chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+    allocated = allocationCount() - allocated;
+
+    cout << "  " << label << ": " << elapsed.count() / lookups << " ns/lookup";
+    if (COUNTS_ALLOCATIONS) {
+        cout << ", " << allocated * 1.0 / lookups << " allocations/lookup";
+    }
+    cout << endl;
+    if (found != lookups) {
+        cout << "  (" << lookups - found << " lookups missed)" << endl;
+    }
+}
+
+/**
+ * Load bids into a chained table using a node allocator and print
+ * the heap allocations the load made and the time taken to
+ * destroy the table
+ *
+ * @param label name of the allocator
+ */
+template <typename Hasher, template <typename> class Allocator>
+void timeLoadAndTeardown(const string& label, const vector<Bid>& bids) {
+    size_t allocated = allocationCount();
+    HashTable<Hasher, Allocator>* table = new HashTable<Hasher, Allocator>();
+    for (auto const& bid : bids) {
+        table->Insert(bid);
+    }
+    allocated = allocationCount() - allocated;
+
+    auto start = chrono::steady_clock::now();
+    delete table;
+    chrono::duration<double, micro> elapsed = chrono::steady_clock::now() - start;
+
+    cout << "  " << label << ": ";
+    if (COUNTS_ALLOCATIONS) {
+        cout << allocated << " allocations to load, ";
+    }
+    cout << elapsed.count() << " us to destroy" << endl;
+}
+
+/**
+ * Compare lookup times of the chained and the open addressing
+ * tables on the same bids, looked up in random order, both
+ * tables hash with the Hasher picked on the command line
+ *
+ * @param csvPath the path to the CSV file to load
+ * @param rounds how many times every bid id is looked up
+ */
+template <typename Hasher>
+void benchmarkTables(string csvPath, unsigned int rounds) {
+    vector<Bid> bids = readBids(csvPath);
+
+    HashTable<Hasher> chained;
+    FlatHashTable<Hasher> flat;
+    vector<string> keys;
+    for (auto const& bid : bids) {
+        chained.Insert(bid);
+        flat.Insert(bid);
+        keys.push_back(bid.bidId);
+    }
+    shuffle(keys.begin(), keys.end(), mt19937(42));
+
+    cout << bids.size() << " bids, " << rounds << " rounds" << endl;
+    if (!COUNTS_ALLOCATIONS) {
+        cout << "(build the Benchmark configuration to count allocations)" << endl;
+    }
+    timeLookups("chained        ", chained, keys, rounds, false);
+    timeLookups("flat           ", flat, keys, rounds, false);
+    timeLookups("chained (copy) ", chained, keys, rounds, true);
+    timeLookups("flat (copy)    ", flat, keys, rounds, true);
+    timeBatchLookups("chained (batch)", chained, keys, rounds);
+    timeBatchLookups("flat (batch)   ", flat, keys, rounds);
+
+    timeLoadAndTeardown<Hasher, pool::Arena>("chained (arena)", bids);
+    timeLoadAndTeardown<Hasher, pool::Heap>("chained (heap) ", bids);
+}
+
+/**
+ * Hammer a ConcurrentHashTable from several threads and check
+ * every answer. Each thread owns its own bid ids, so it knows
+ * what Search must return for them, and also looks up the ids of
+ * the other threads to keep the shard locks contended.
+ *
+ * @param threads number of threads to run
+ * @param opsPerThread operations each thread performs
+ * @return the number of wrong answers, 0 when the table is sound
+ */
+template <typename Hasher>
+size_t stressConcurrent(unsigned int threads, unsigned int opsPerThread) {
+    const unsigned int IDS_PER_THREAD = 1000;
+
+    ConcurrentHashTable<Hasher> table(16);
+    atomic<size_t> errors(0);
+    vector<size_t> sizes(threads);
+
+    vector<thread> workers;
+    for (unsigned int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            mt19937 random(t + 1);
+            vector<bool> present(IDS_PER_THREAD, false);
+            Bid bid;
+
+            for (unsigned int op = 0; op < opsPerThread; ++op) {
+                unsigned int k = random() % IDS_PER_THREAD;
+                string bidId = to_string(t) + "-" + to_string(k);
+
+                switch (random() % 4) {
+                case 0:
+                    if (!present[k]) {
+                        Bid added;
+                        added.bidId = bidId;
+                        added.title = bidId;
+                        table.Insert(added);
+                        present[k] = true;
+                    }
+                    break;
+                case 1:
+                    table.Remove(bidId);
+                    present[k] = false;
+                    break;
+                case 2:
+                    if (table.Search(bidId, bid) != present[k]
+                            || (present[k] && bid.title != bidId)) {
+                        ++errors;
+                    }
+                    break;
+                default:
+                    // another thread's id, the answer can't be checked
+                    table.Search(to_string(random() % threads) + "-" + to_string(k), bid);
+                }
+            }
+
+            for (unsigned int k = 0; k < IDS_PER_THREAD; ++k) {
+                if (table.Search(to_string(t) + "-" + to_string(k), bid) != present[k]) {
+                    ++errors;
+                }
+            }
+            sizes[t] = count(present.begin(), present.end(), true);
+        });
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+
+    size_t expected = 0;
+    for (size_t n : sizes) {
+        expected += n;
+    }
+    if (table.Size() != expected) {
+        ++errors;
+    }
+    return errors;
+}
+
+/**
+ * Run the concurrent table stress test, then measure how a mixed
+ * workload of 90% searches and 10% remove + insert pairs scales
+ * from 1 to maxThreads threads, with a single shard (one lock for
+ * the whole table) and with 64 shards
+ *
+ * @param csvPath the path to the CSV file to load
+ * @param maxThreads the largest number of threads to run
+ */
+template <typename Hasher>
+void benchmarkConcurrent(string csvPath, unsigned int maxThreads) {
+    const unsigned int OPERATIONS = 2000000;
+
+    unsigned int stressThreads = max(maxThreads, 4u);
+    cout << "stress test, " << stressThreads << " threads: ";
+    size_t errors = stressConcurrent<Hasher>(stressThreads, 100000);
+    if (errors == 0) {
+        cout << "passed" << endl;
+    } else {
+        cout << errors << " wrong answers" << endl;
+    }
+
+    vector<Bid> bids = readBids(csvPath);
+    if (bids.empty()) {
+        return;
+    }
+
+    vector<unsigned int> threadCounts;
+    for (unsigned int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    cout << bids.size() << " bids, " << OPERATIONS << " operations per run" << endl;
+    for (unsigned int shardCount : { 1u, 64u }) {
+        double baseRate = 0;
+
+        for (unsigned int threads : threadCounts) {
+            ConcurrentHashTable<Hasher> table(shardCount);
+            table.reserve(bids.size());
+            for (auto const& bid : bids) {
+                table.Insert(bid);
+            }
+
+            auto start = chrono::steady_clock::now();
+            vector<thread> workers;
+            for (unsigned int t = 0; t < threads; ++t) {
+                workers.emplace_back([&, t]() {
+                    mt19937 random(t + 1);
+                    Bid bid;
+                    for (unsigned int op = 0; op < OPERATIONS / threads; ++op) {
+                        const Bid& pick = bids[random() % bids.size()];
+                        if (random() % 10 != 0) {
+                            table.Search(pick.bidId, bid);
+                        } else {
+                            table.Remove(pick.bidId);
+                            table.Insert(pick);
+                        }
+                    }
+                });
+            }
+            for (thread& worker : workers) {
+                worker.join();
+            }
+            chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+            double rate = OPERATIONS / elapsed.count() / 1e6;
+            if (baseRate == 0) {
+                baseRate = rate;
+            }
+            cout << "  " << shardCount << (shardCount == 1 ? " shard,  " : " shards, ")
+                 << threads << " threads: " << rate << " Mops/s, speedup "
+                 << rate / baseRate << endl;
+        }
+    }
+}
+
+/**
+ * Time the CSV record scanner against the byte at a time loop it
+ * replaced, both walking the whole file, averaged over SCAN_ROUNDS
+ * runs, and check they find the same separators
+ *
+ * @param csvPath the path to the CSV file to scan
+ */
+void benchmarkScanner(string csvPath) {
+    const int SCAN_ROUNDS = 10;
+
+    try {
+        csv::MappedFile file(csvPath);
+
+        // a first pass pages the file in before anything is timed
+        size_t expected = csv::countSeparators(file, ',', true);
+
+        cout << file.size() << " bytes, " << SCAN_ROUNDS << " rounds" << endl;
+        for (bool bytes : { false, true }) {
+            size_t separators = 0;
+            auto start = chrono::steady_clock::now();
+            for (int round = 0; round < SCAN_ROUNDS; ++round) {
+                separators = csv::countSeparators(file, ',', bytes);
+            }
+            chrono::duration<double, micro> elapsed = chrono::steady_clock::now() - start;
+
+            // bytes per microsecond are MB/s
+            cout << "  " << (bytes ? "byte loop" : csv::scannerName()) << ": "
+                 << file.size() * SCAN_ROUNDS / elapsed.count() << " MB/s";
+            if (separators != expected) {
+                cout << " (found " << separators << " separators, expected " << expected << ")";
+            }
+            cout << endl;
+        }
+    } catch (csv::Error &e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+/**
+ * Run the interactive menu on a hash table
+ *
+ * @param bidTable the HashTable or FlatHashTable holding the bids
+ * @param csvPath the path to the CSV file to load
+ * @param bidKey the bid Id to search for and remove
+ * @param threads the most threads the concurrent benchmark runs
+ */
+template <typename Hasher, typename Table>
+void runMenu(Table* bidTable, string csvPath, string bidKey, unsigned int threads) {
+
+    // Define a timer variable
+    clock_t ticks;
+
+    const Bid* found = nullptr;
+
+    int choice = 0;
+    while (choice != 9) {
+        cout << "Menu:" << endl;
+        cout << "  1. Load Bids" << endl;
+        cout << "  2. Display All Bids" << endl;
+        cout << "  3. Find Bid" << endl;
+        cout << "  4. Remove Bid" << endl;
+        cout << "  5. Benchmark Lookups" << endl;
+        cout << "  6. Show Hash Distribution" << endl;
+        cout << "  7. Benchmark Concurrent Table" << endl;
+        cout << "  8. Benchmark CSV Scanner" << endl;
+        cout << "  9. Exit" << endl;
+        cout << "Enter choice: ";
+        cin >> choice;
+
+        switch (choice) {
+
+        case 1:
+            
+            // Initialize a timer variable before loading bids
+            ticks = clock();
+
+            // Complete the method call to load the bids
+            loadBids(csvPath, bidTable);
+
+            // Calculate elapsed time and display result
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            break;
+
+        case 2:
+            bidTable->PrintAll();
+            break;
+
+        case 3:
+            ticks = clock();
+
+            found = bidTable->Search(bidKey);
+
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+
+            if (found != nullptr) {
+                displayBid(*found);
+            } else {
+                cout << "Bid Id " << bidKey << " not found." << endl;
+            }
+
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            break;
+
+        case 4:
+            bidTable->Remove(bidKey);
+            break;
+
+        case 5:
+            benchmarkTables<Hasher>(csvPath, 100);
+            break;
+
+        case 6:
+            bidTable->PrintDistribution();
+            break;
+
+        case 7:
+            benchmarkConcurrent<Hasher>(csvPath, threads);
+            break;
+
+        case 8:
+            benchmarkScanner(csvPath);
+            break;
+        }
+    }
+}
+
+/**
+ * Run the menu on the table selected on the command line
+ *
+ * @param flat use the open addressing table
+ * @param csvPath the path to the CSV file to load
+ * @param bidKey the bid Id to search for and remove
+ * @param threads the most threads the concurrent benchmark runs
+ */
+template <typename Hasher>
+void runTable(bool flat, string csvPath, string bidKey, unsigned int threads) {
+    // Define a hash table to hold all the bids
+    if (flat) {
+        FlatHashTable<Hasher> bidTable;
+        runMenu<Hasher>(&bidTable, csvPath, bidKey, threads);
+    } else {
+        HashTable<Hasher> bidTable;
+        runMenu<Hasher>(&bidTable, csvPath, bidKey, threads);
+    }
+}
+
+/**
+ * The one and only main() method
+ *
+ * @param --flat use the open addressing table (optional), it behaves
+ *        like the chained one: a bid inserted again under the same
+ *        id replaces the first
+ * @param --atoi-hash hash the numeric value of the ids (optional)
+ * @param --threads=N most threads for the concurrent benchmark (optional,
+ *        defaults to the number of hardware threads)
+ * @param arg[1] path to CSV file to load from (optional)
+ * @param arg[2] the bid Id to use when searching the table (optional)
+ */
+int main(int argc, char* argv[]) {
+
+    // process command line options, then arguments
+    bool flat = false;
+    bool atoiHash = false;
+    unsigned int threads = max(thread::hardware_concurrency(), 1u);
+    int arg = 1;
+    for (; arg < argc && string(argv[arg]).rfind("--", 0) == 0; ++arg) {
+        if (string(argv[arg]) == "--flat") {
+            flat = true;
+        } else if (string(argv[arg]) == "--atoi-hash") {
+            atoiHash = true;
+        } else if (string(argv[arg]).rfind("--threads=", 0) == 0 && atoi(argv[arg] + 10) > 0) {
+            threads = atoi(argv[arg] + 10);
+        } else {
+            cerr << "Unknown option " << argv[arg] << endl;
+            return 1;
+        }
+    }
+
+    string csvPath, bidKey;
+    switch (argc - arg) {
+    case 1:
+        csvPath = argv[arg];
+        bidKey = "98223";
+        break;
+    case 2:
+        csvPath = argv[arg];
+        bidKey = argv[arg + 1];
+        break;
+    default:
+        csvPath = "eBid_Monthly_Sales.csv";
+        bidKey = "98223";
+    }
+
+    if (atoiHash) {
+        runTable<AtoiHash>(flat, csvPath, bidKey, threads);
+    } else {
+        runTable<BidHash>(flat, csvPath, bidKey, threads);
+    }
+
+    cout << "Good bye." << endl;
+
+    return 0;
+}
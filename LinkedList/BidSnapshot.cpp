@@ -0,0 +1,211 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "BidSnapshot.hpp"
+
+namespace snapshot {
+
+  static const char MAGIC[8] = { 'B', 'I', 'D', 'S', 'N', 'A', 'P', '\0' };
+  // 3: text fields are stored unquoted
+  static const std::uint32_t VERSION = 3;
+
+  enum Field {
+      eID = 0,
+      eTITLE = 1,
+      eFUND = 2
+  };
+
+  // size and modification time of the CSV file, to detect stale snapshots
+  static bool stamp(const std::string &source, std::uint64_t &size, std::int64_t &time)
+  {
+      std::error_code ec;
+      size = std::filesystem::file_size(source, ec);
+      if (ec)
+          return false;
+      time = std::filesystem::last_write_time(source, ec).time_since_epoch().count();
+      return !ec;
+  }
+
+  std::string pathFor(const std::string &csvPath)
+  {
+      return csvPath + ".snap";
+  }
+
+  /*
+  ** WRITER
+  */
+
+  Writer::Writer(void) : _flags(0) {}
+
+  std::uint32_t Writer::intern(std::string_view value, std::uint32_t &length)
+  {
+      auto it = _offsets.find(std::string(value));
+      if (it != _offsets.end())
+      {
+          length = static_cast<std::uint32_t>(value.size());
+          return it->second;
+      }
+
+      // offsets and lengths are 32 bits wide
+      if (value.size() > UINT32_MAX - _strings.size())
+          throw Error("too many strings for a snapshot (4 GiB at most)");
+
+      length = static_cast<std::uint32_t>(value.size());
+      std::uint32_t offset = static_cast<std::uint32_t>(_strings.size());
+      _strings.append(value.data(), value.size());
+      _offsets.emplace(std::string(value), offset);
+      return offset;
+  }
+
+  void Writer::add(std::string_view bidId, std::string_view title,
+                   std::string_view fund, long long amount)
+  {
+      if (_records.size() == UINT32_MAX)
+          throw Error("too many records for a snapshot");
+
+      Record record;
+
+      record.offset[eID] = intern(bidId, record.length[eID]);
+      record.offset[eTITLE] = intern(title, record.length[eTITLE]);
+      record.offset[eFUND] = intern(fund, record.length[eFUND]);
+      record.closeDate = 0;
+      record.reserved = 0;
+      record.amount = amount;
+      _records.push_back(record);
+  }
+
+  void Writer::add(std::string_view bidId, std::string_view title,
+                   std::string_view fund, long long amount,
+                   const csv::Date &closeDate)
+  {
+      add(bidId, title, fund, amount);
+      _records.back().closeDate = static_cast<std::uint32_t>(
+          closeDate.year * 10000 + closeDate.month * 100 + closeDate.day);
+      _flags |= HAS_DATES;
+  }
+
+  void Writer::write(const std::string &path, const std::string &source) const
+  {
+      Header header;
+
+      std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+      header.version = VERSION;
+      header.count = static_cast<std::uint32_t>(_records.size());
+      header.stringsSize = _strings.size();
+      header.flags = _flags;
+      if (!stamp(source, header.sourceSize, header.sourceTime))
+          throw Error(std::string("Failed to stat ").append(source));
+
+      // write to a temporary file first so readers never see half a snapshot
+      std::string tmp = path + ".tmp";
+      {
+          std::ofstream f(tmp.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+          if (!f.is_open())
+              throw Error(std::string("Failed to open ").append(tmp));
+          f.write(reinterpret_cast<const char *>(&header), sizeof(header));
+          f.write(reinterpret_cast<const char *>(_records.data()), _records.size() * sizeof(Record));
+          f.write(_strings.data(), _strings.size());
+          if (!f.good())
+              throw Error(std::string("Failed to write ").append(tmp));
+      }
+
+      std::error_code ec;
+      std::filesystem::rename(tmp, path, ec);
+      if (ec)
+          throw Error(std::string("Failed to write ").append(path));
+  }
+
+  /*
+  ** READER
+  */
+
+  Reader::Reader(const std::string &path)
+    : _header(NULL), _records(NULL), _strings(NULL)
+  {
+      try
+      {
+          _file.reset(new csv::MappedFile(path));
+      }
+      catch (csv::Error &)
+      {
+          throw Error(std::string("Failed to open ").append(path));
+      }
+
+      // check the layout once, accessors then only bound-check offsets
+      if (_file->size() < sizeof(Header))
+          throw Error(std::string("Truncated ").append(path));
+      _header = reinterpret_cast<const Header *>(_file->data());
+      if (std::memcmp(_header->magic, MAGIC, sizeof(MAGIC)) != 0 || _header->version != VERSION)
+          throw Error(std::string("Not a bid snapshot ").append(path));
+      if (_file->size() != sizeof(Header) + _header->count * sizeof(Record) + _header->stringsSize)
+          throw Error(std::string("Truncated ").append(path));
+
+      _records = reinterpret_cast<const Record *>(_file->data() + sizeof(Header));
+      _strings = _file->data() + sizeof(Header) + _header->count * sizeof(Record);
+  }
+
+  bool Reader::fresh(const std::string &source) const
+  {
+      std::uint64_t size;
+      std::int64_t time;
+
+      return stamp(source, size, time)
+          && size == _header->sourceSize && time == _header->sourceTime;
+  }
+
+  unsigned int Reader::size(void) const
+  {
+      return _header->count;
+  }
+
+  std::string_view Reader::field(unsigned int pos, int which) const
+  {
+      if (pos >= _header->count)
+          throw Error("can't return this record (doesn't exist)");
+
+      const Record &record = _records[pos];
+      if (static_cast<std::uint64_t>(record.offset[which]) + record.length[which] > _header->stringsSize)
+          throw Error("corrupted string table !");
+      return std::string_view(_strings + record.offset[which], record.length[which]);
+  }
+
+  std::string_view Reader::bidId(unsigned int pos) const
+  {
+      return field(pos, eID);
+  }
+
+  std::string_view Reader::title(unsigned int pos) const
+  {
+      return field(pos, eTITLE);
+  }
+
+  std::string_view Reader::fund(unsigned int pos) const
+  {
+      return field(pos, eFUND);
+  }
+
+  long long Reader::amount(unsigned int pos) const
+  {
+      if (pos >= _header->count)
+          throw Error("can't return this record (doesn't exist)");
+      return _records[pos].amount;
+  }
+
+  bool Reader::hasDates(void) const
+  {
+      return (_header->flags & HAS_DATES) != 0;
+  }
+
+  csv::Date Reader::closeDate(unsigned int pos) const
+  {
+      if (pos >= _header->count)
+          throw Error("can't return this record (doesn't exist)");
+
+      std::uint32_t date = _records[pos].closeDate;
+      csv::Date value;
+      value.year = static_cast<int>(date / 10000);
+      value.month = static_cast<int>(date / 100 % 100);
+      value.day = static_cast<int>(date % 100);
+      return value;
+  }
+}
@@ -1,458 +1,809 @@
-//============================================================================
-// Name        : LinkedList.cpp
-// Author      : Your Name
-// Version     : 1.0
-// Copyright   : Copyright  2023 SNHU COCE
-// Description : Lab 3-2 Lists and Searching
-//============================================================================
-
-#include <algorithm>
-#include <iostream>
-#include <time.h>
-#include <iostream>
-#include "CSVparser.hpp"
-
-using namespace std;
-
-//============================================================================
-// Global definitions visible to all methods and classes
-//============================================================================
-
-// forward declarations
-double strToDouble(string str, char ch);
-
-// define a structure to hold bid information
-struct Bid {
-    string bidId; // unique identifier
-    string title;
-    string fund;
-    double amount;
-    Bid() {
-        amount = 0.0;
-    }
-};
-
-//============================================================================
-// Linked-List class definition
-//============================================================================
-
-/**
- * Define a class containing data members and methods to
- * implement a linked-list.
- */
-class LinkedList {
-
-private:
-    //Internal structure for list entries, housekeeping variables
-    struct Node {
-        Bid bid;
-        Node *next;
-
-        // default constructor
-        Node() {
-            next = nullptr;
-        }
-
-        // initialize with a bid
-        Node(Bid aBid) {
-            bid = aBid;
-            next = nullptr;
-        }
-    };
-
-    Node* head;
-    Node* tail;
-    int size = 0;
-
-public:
-    LinkedList();
-    virtual ~LinkedList();
-    void Append(Bid bid);
-    void Prepend(Bid bid);
-    void PrintList();
-    void Remove(string bidId);
-    Bid Search(string bidId);
-    int Size();
-};
-
-/**
- * Default constructor
- */
-LinkedList::LinkedList() {
-    // FIXME (1): Initialize housekeeping variables
-    head = nullptr;
-    tail = nullptr;
-    //set head and tail equal to nullptr
-}
-
-/**
- * Destructor
- */
-LinkedList::~LinkedList() {
-    // start at the head
-    Node* current = head;
-    Node* temp;
-
-    // loop over each node, detach from list then delete
-    while (current != nullptr) {
-        temp = current; // hang on to current node
-        current = current->next; // make current the next node
-        delete temp; // delete the orphan node
-    }
-}
-
-/**
- * Append a new bid to the end of the list
- */
-void LinkedList::Append(Bid bid) {
-    // FIXME (2): Implement append logic
-    //Create new node
-    //if there is nothing at the head...
-            // new node becomes the head and the tail
-    if (head == nullptr) {
-        head = new Node;
-        head->bid = bid;
-        head->next = nullptr;
-    }
-    //else 
-        // make current tail node point to the new node
-        // and tail becomes the new node
-    else {
-        Node* temp = head;
-        Node* current;
-        while (temp != nullptr) {
-            current = temp;
-            temp = temp->next;
-        }
-        
-    }
-    //increase size count
-}
-
-/**
- * Prepend a new bid to the start of the list
- */
-void LinkedList::Prepend(Bid bid) {
-    // FIXME (3): Implement prepend logic
-    // Create new node
-    if (head == nullptr) {
-        head = new Node;
-        head->bid = bid;
-        head->next = nullptr;
-    }
-    else {
-        Node* temp = head;
-        head = new Node;
-        head->bid = bid;
-        head->next = temp;
-    }
-
-    // if there is already something at the head...
-        // new node points to current head as its next node
-
-    // head now becomes the new node
-    //increase size count
-
-}
-
-/**
- * Simple output of all bids in the list
- */
-void LinkedList::PrintList() {
-    // FIXME (4): Implement print logic
-    // start at the head
-    if (head = nullptr) {
-        cout << "There are no items to print" << endl;
-    }
-    else {
-        Node* temp = head;
-        while (temp != nullptr) {
-            cout << temp->bid.bidId << ": " << temp->bid.title << " | " << temp->bid.amount << " | " << temp->bid.fund << endl;
-            temp = temp->next;
-        }
-    }
-    // whilee, amount and fund
-        //set current equal to next loop over each node looking for a match
-        //output current bidID, titl
-}
-
-/**
- * Remove a specified bid
- *
- * @param bidId The bid id to remove from the list
- */
-void LinkedList::Remove(string bidId) {
-    // FIXME (5): Implement remove logic
-    // special case if matching node is the head
-        // make head point to the next node in the list
-        //decrease size count
-        //return
-    Node* temp = head;
-    if (temp == nullptr) {
-        cout << "There are no matching nodes in this list. Attempt aborted." << endl;
-    }
-    while (temp != nullptr) {
-        if (temp->bid.bidId == bidId) {
-            if (temp == head) {
-                head = head->next;
-                temp = nullptr;
-                cout << "Record has been found an deleted" << endl;
-                break;
-            }
-        }
-        else {
-            Node* current = temp;
-            temp = temp->next;
-            if (temp->bid.bidId == bidId) {
-                current->next = temp->next;
-                temp = nullptr;
-                cout << "Record has been found and deleted" << endl;
-                break;
-            }
-            if (temp->bid.bidId != bidId && temp->next == nullptr) {
-                cout << "No record with that ID number exists" << endl;
-                break;
-            }
-        }
-    }
-    // start at the head
-    // while loop over each node looking for a match
-        // if the next node bidID is equal to the current bidID
-        	// hold onto the next node temporarily
-         // make current node point beyond the next node
-         // now free up memory held by temp
-         // decrease size count
-         //return
-
-    // current node is equal to next node
-    
-
-}
-
-/**
- * Search for the specified bidId
- *
- * @param bidId The bid id to search for
- */
-Bid LinkedList::Search(string bidId) {
-    // FIXME (6): Implement search logic
-
-    // special case if matching bid is the head
-    Node* temp = head;
-    Bid returnBid;
-    if (temp == nullptr) {
-        cout << "No nodes in this list. Search aborted" << endl;
-        return returnBid;
-    }
-    else {
-        while (temp != nullptr) {
-            if (temp->bid.bidId == bidId) {
-                returnBid = temp->bid;
-                break;
-            }
-            temp = temp->next;
-        }
-    }
-    return returnBid;
-    // start at the head of the list
-
-    // keep searching until end reached with while loop (current != nullptr)
-        // if the current node matches, return current bid
-        // else current node is equal to next node
-
-    //(the next two statements will only execute if search item is not found)
-        //create new empty bid
-        //return empty bid 
-}
-
-/**
- * Returns the current size (number of elements) in the list
- */
-int LinkedList::Size() {
-    return size;
-}
-
-//============================================================================
-// Static methods used for testing
-//============================================================================
-
-/**
- * Display the bid information
- *
- * @param bid struct containing the bid info
- */
-void displayBid(Bid bid) {
-    cout << bid.bidId << ": " << bid.title << " | " << bid.amount
-         << " | " << bid.fund << endl;
-    return;
-}
-
-/**
- * Prompt user for bid information
- *
- * @return Bid struct containing the bid info
- */
-Bid getBid() {
-    Bid bid;
-
-    cout << "Enter Id: ";
-    cin.ignore();
-    getline(cin, bid.bidId);
-
-    cout << "Enter title: ";
-    getline(cin, bid.title);
-
-    cout << "Enter fund: ";
-    cin >> bid.fund;
-
-    cout << "Enter amount: ";
-    cin.ignore();
-    string strAmount;
-    getline(cin, strAmount);
-    bid.amount = strToDouble(strAmount, '$');
-
-    return bid;
-}
-
-/**
- * Load a CSV file containing bids into a LinkedList
- *
- * @return a LinkedList containing all the bids read
- */
-void loadBids(string csvPath, LinkedList *list) {
-    cout << "Loading CSV file " << csvPath << endl;
-
-    // initialize the CSV Parser
-    csv::Parser file = csv::Parser(csvPath);
-
-    try {
-        // loop to read rows of a CSV file
-        for (int i = 0; i < file.rowCount(); i++) {
-
-            // initialize a bid using data from current row (i)
-            Bid bid;
-            bid.bidId = file[i][1];
-            bid.title = file[i][0];
-            bid.fund = file[i][8];
-            bid.amount = strToDouble(file[i][4], '$');
-
-            //cout << bid.bidId << ": " << bid.title << " | " << bid.fund << " | " << bid.amount << endl;
-
-            // add this bid to the end
-            list->Append(bid);
-        }
-    } catch (csv::Error &e) {
-        std::cerr << e.what() << std::endl;
-    }
-}
-
-/**
- * Simple C function to convert a string to a double
- * after stripping out unwanted char
- *
- * credit: http://stackoverflow.com/a/24875936
- *
- * @param ch The character to strip out
- */
-double strToDouble(string str, char ch) {
-    str.erase(remove(str.begin(), str.end(), ch), str.end());
-    return atof(str.c_str());
-}
-
-/**
- * The one and only main() method
- *
- * @param arg[1] path to CSV file to load from (optional)
- * @param arg[2] the bid Id to use when searching the list (optional)
- */
-int main(int argc, char* argv[]) {
-
-    // process command line arguments
-    string csvPath, bidKey;
-    switch (argc) {
-    case 2:
-        csvPath = argv[1];
-        bidKey = "98109";
-        break;
-    case 3:
-        csvPath = argv[1];
-        bidKey = argv[2];
-        break;
-    default:
-        csvPath = "eBid_Monthly_Sales.csv";
-        bidKey = "98109";
-    }
-
-    clock_t ticks;
-
-    LinkedList bidList;
-
-    Bid bid;
-
-    int choice = 0;
-    while (choice != 9) {
-        cout << "Menu:" << endl;
-        cout << "  1. Enter a Bid" << endl;
-        cout << "  2. Load Bids" << endl;
-        cout << "  3. Display All Bids" << endl;
-        cout << "  4. Find Bid" << endl;
-        cout << "  5. Remove Bid" << endl;
-        cout << "  9. Exit" << endl;
-        cout << "Enter choice: ";
-        cin >> choice;
-
-        switch (choice) {
-        case 1:
-            bid = getBid();
-            bidList.Append(bid);
-            displayBid(bid);
-
-            break;
-
-        case 2:
-            ticks = clock();
-
-            loadBids(csvPath, &bidList);
-
-            cout << bidList.Size() << " bids read" << endl;
-
-            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
-            cout << "time: " << ticks << " milliseconds" << endl;
-            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
-
-            break;
-
-        case 3:
-            bidList.PrintList();
-
-            break;
-
-        case 4:
-            ticks = clock();
-
-            bid = bidList.Search(bidKey);
-
-            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
-
-            if (!bid.bidId.empty()) {
-                displayBid(bid);
-            } else {
-            	cout << "Bid Id " << bidKey << " not found." << endl;
-            }
-
-            cout << "time: " << ticks << " clock ticks" << endl;
-            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
-
-            break;
-
-        case 5:
-            bidList.Remove(bidKey);
-
-            break;
-        }
-    }
-
-    cout << "Good bye." << endl;
-
-    return 0;
-}
+//============================================================================
+// Name        : LinkedList.cpp
+// Author      : Your Name
+// Version     : 1.0
+// Copyright   : Copyright  2023 SNHU COCE
+// Description : Lab 3-2 Lists and Searching
+//============================================================================
+
+#include <algorithm>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <time.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <iostream>
+#include "BidSnapshot.hpp"
+#include "CSVparser.hpp"
+#include "NodePool.hpp"
+
+using namespace std;
+
+//============================================================================
+// Global definitions visible to all methods and classes
+//============================================================================
+
+// define a structure to hold bid information
+struct Bid {
+    string bidId; // unique identifier
+    string title;
+    csv::Symbol fund; // interned, only a few distinct funds
+    long long amount; // winning bid in cents
+    Bid() {
+        amount = 0;
+    }
+};
+
+//============================================================================
+// Skip list class definition
+//============================================================================
+
+/**
+ * Define a class keeping bids ordered by title as they are added
+ * and removed, so ordered output never needs a sort.
+ *
+ * Every node is linked on level 0 and, with probability 1/4 per
+ * level, on the levels above, each of which skips about four nodes
+ * of the one below. Inserting and removing a bid take O(log(n))
+ * expected steps. Equal titles keep the order they were inserted
+ * in. Nodes point at bids owned by the caller and come from the
+ * Allocator, like the list's, one per height so that every node only
+ * takes room for the links it is on (about 1.33 on average).
+ */
+template <template <typename> class Allocator = pool::Arena>
+class SkipList {
+
+private:
+    // 4^12 bids before the top level fills up
+    static const int MAX_LEVEL = 12;
+
+    struct Node {
+        const Bid* bid;
+        int height; // levels the node is linked on
+        Node* next[1]; // the first of height links, the rest follow it
+    };
+
+    // a node with room for HEIGHT links
+    template <int HEIGHT>
+    struct TallNode : Node {
+        Node* more[HEIGHT - 1];
+    };
+
+    template <int HEIGHT>
+    using Tower = conditional_t<HEIGHT == 1, Node, TallNode<HEIGHT>>;
+
+    template <size_t... LEVEL>
+    static tuple<Allocator<Tower<LEVEL + 1>>...> MakeAllocators(index_sequence<LEVEL...>);
+
+    // nodeAllocators[h - 1] allocates the nodes of height h
+    decltype(MakeAllocators(make_index_sequence<MAX_LEVEL>())) nodeAllocators;
+
+    Node* head; // linked on every level, holds no bid
+    int level; // levels in use
+    int size;
+    mt19937 random;
+
+    int RandomHeight();
+    template <int HEIGHT = 1>
+    Node* CreateNode(const Bid* bid, int height);
+    template <int HEIGHT = 1>
+    void DestroyNode(Node* node);
+
+public:
+    SkipList();
+    virtual ~SkipList();
+    void Insert(const Bid* bid);
+    void Remove(const Bid* bid);
+    template <typename Visit>
+    void ForEach(Visit visit) const;
+    int Size();
+};
+
+/**
+ * Default constructor
+ */
+template <template <typename> class Allocator>
+SkipList<Allocator>::SkipList() {
+    head = CreateNode(nullptr, MAX_LEVEL);
+    level = 1;
+    size = 0;
+}
+
+/**
+ * Destructor
+ */
+template <template <typename> class Allocator>
+SkipList<Allocator>::~SkipList() {
+    // an arena frees the nodes all at once
+    if (Allocator<Node>::RELEASES_ALL) {
+        return;
+    }
+
+    Node* current = head;
+    while (current != nullptr) {
+        Node* temp = current;
+        current = current->next[0];
+        DestroyNode(temp);
+    }
+}
+
+/**
+ * Pick the height of a new node: 1, then one more level with
+ * probability 1/4 each time
+ */
+template <template <typename> class Allocator>
+int SkipList<Allocator>::RandomHeight() {
+    int height = 1;
+    while (height < MAX_LEVEL && (random() & 3) == 0) {
+        ++height;
+    }
+    return height;
+}
+
+/**
+ * Allocate a node of a given height from the allocator of that
+ * height, its links all null
+ *
+ * @param bid the bid of the node
+ * @param height levels the node will be linked on
+ */
+template <template <typename> class Allocator>
+template <int HEIGHT>
+typename SkipList<Allocator>::Node* SkipList<Allocator>::CreateNode(const Bid* bid, int height) {
+    if constexpr (HEIGHT < MAX_LEVEL) {
+        if (height != HEIGHT) {
+            return CreateNode<HEIGHT + 1>(bid, height);
+        }
+    }
+    Node* node = get<HEIGHT - 1>(nodeAllocators).create();
+    node->bid = bid;
+    node->height = HEIGHT;
+    return node;
+}
+
+/**
+ * Give a node back to the allocator of its height
+ *
+ * @param node the node to destroy
+ */
+template <template <typename> class Allocator>
+template <int HEIGHT>
+void SkipList<Allocator>::DestroyNode(Node* node) {
+    if constexpr (HEIGHT < MAX_LEVEL) {
+        if (node->height != HEIGHT) {
+            DestroyNode<HEIGHT + 1>(node);
+            return;
+        }
+    }
+    get<HEIGHT - 1>(nodeAllocators).destroy(static_cast<Tower<HEIGHT>*>(node));
+}
+
+/**
+ * Insert a bid after every bid with a lower or equal title
+ *
+ * @param bid the bid to insert, it must outlive its node
+ */
+template <template <typename> class Allocator>
+void SkipList<Allocator>::Insert(const Bid* bid) {
+    // on each level, the last node that goes before the bid
+    Node* update[MAX_LEVEL];
+    Node* current = head;
+    for (int i = level - 1; i >= 0; --i) {
+        while (current->next[i] != nullptr && current->next[i]->bid->title.compare(bid->title) <= 0) {
+            current = current->next[i];
+        }
+        update[i] = current;
+    }
+
+    int height = RandomHeight();
+    for (int i = level; i < height; ++i) {
+        update[i] = head;
+    }
+    level = max(level, height);
+
+    Node* node = CreateNode(bid, height);
+    for (int i = 0; i < height; ++i) {
+        node->next[i] = update[i]->next[i];
+        update[i]->next[i] = node;
+    }
+    ++size;
+}
+
+/**
+ * Remove a bid, found by address among the bids with its title
+ *
+ * @param bid the bid to remove, as given to Insert
+ */
+template <template <typename> class Allocator>
+void SkipList<Allocator>::Remove(const Bid* bid) {
+    // on each level, the last node with a lower title
+    Node* update[MAX_LEVEL];
+    Node* current = head;
+    for (int i = level - 1; i >= 0; --i) {
+        while (current->next[i] != nullptr && current->next[i]->bid->title.compare(bid->title) < 0) {
+            current = current->next[i];
+        }
+        update[i] = current;
+    }
+
+    // walk the equal titles to the node of this bid
+    Node* node = update[0]->next[0];
+    while (node != nullptr && node->bid != bid && node->bid->title == bid->title) {
+        node = node->next[0];
+    }
+    if (node == nullptr || node->bid != bid) {
+        return;
+    }
+
+    // unlink it on every level it is on
+    for (int i = 0; i < node->height; ++i) {
+        Node* prev = update[i];
+        while (prev->next[i] != node) {
+            prev = prev->next[i];
+        }
+        prev->next[i] = node->next[i];
+    }
+    while (level > 1 && head->next[level - 1] == nullptr) {
+        --level;
+    }
+
+    DestroyNode(node);
+    --size;
+}
+
+/**
+ * Call a function on every bid, in title order
+ *
+ * @param visit function taking a const Bid&
+ */
+template <template <typename> class Allocator>
+template <typename Visit>
+void SkipList<Allocator>::ForEach(Visit visit) const {
+    for (const Node* node = head->next[0]; node != nullptr; node = node->next[0]) {
+        visit(*node->bid);
+    }
+}
+
+/**
+ * Returns the current size (number of bids) in the skip list
+ */
+template <template <typename> class Allocator>
+int SkipList<Allocator>::Size() {
+    return size;
+}
+
+//============================================================================
+// Linked-List class definition
+//============================================================================
+
+/**
+ * Define a class containing data members and methods to
+ * implement a linked-list.
+ *
+ * Nodes come from the Allocator (see NodePool.hpp), an arena by
+ * default so loading makes few allocations and the destructor
+ * sweeps whole chunks instead of walking the list, the bids'
+ * strings are still freed one by one. A skip list of
+ * the same bids is kept in title order alongside.
+ */
+template <template <typename> class Allocator = pool::Arena>
+class LinkedList {
+
+private:
+    //Internal structure for list entries, housekeeping variables
+    struct Node {
+        Bid bid;
+        Node *next;
+
+        // default constructor
+        Node() {
+            next = nullptr;
+        }
+
+        // initialize with a bid
+        Node(Bid aBid) {
+            bid = aBid;
+            next = nullptr;
+        }
+    };
+
+    Node* head;
+    Node* tail;
+    int size = 0;
+
+    Allocator<Node> nodeAllocator;
+    SkipList<Allocator> byTitle;
+
+public:
+    LinkedList();
+    virtual ~LinkedList();
+    void Append(Bid bid);
+    void Prepend(Bid bid);
+    void PrintList();
+    void PrintSorted();
+    void Remove(string_view bidId);
+    const Bid* Search(string_view bidId) const;
+    int Size();
+};
+
+/**
+ * Default constructor
+ */
+template <template <typename> class Allocator>
+LinkedList<Allocator>::LinkedList() {
+    // FIXME (1): Initialize housekeeping variables
+    head = nullptr;
+    tail = nullptr;
+    //set head and tail equal to nullptr
+}
+
+/**
+ * Destructor
+ */
+template <template <typename> class Allocator>
+LinkedList<Allocator>::~LinkedList() {
+    // an arena frees the nodes all at once
+    if (Allocator<Node>::RELEASES_ALL) {
+        return;
+    }
+
+    // start at the head
+    Node* current = head;
+    Node* temp;
+
+    // loop over each node, detach from list then delete
+    while (current != nullptr) {
+        temp = current; // hang on to current node
+        current = current->next; // make current the next node
+        nodeAllocator.destroy(temp); // delete the orphan node
+    }
+}
+
+/**
+ * Append a new bid to the end of the list
+ */
+template <template <typename> class Allocator>
+void LinkedList<Allocator>::Append(Bid bid) {
+    // FIXME (2): Implement append logic
+    //Create new node
+    Node* node = nodeAllocator.create(bid);
+
+    //if there is nothing at the head...
+            // new node becomes the head and the tail
+    if (head == nullptr) {
+        head = node;
+        tail = node;
+    }
+    //else 
+        // make current tail node point to the new node
+        // and tail becomes the new node
+    else {
+        tail->next = node;
+        tail = node;
+    }
+    byTitle.Insert(&node->bid);
+    //increase size count
+    ++size;
+}
+
+/**
+ * Prepend a new bid to the start of the list
+ */
+template <template <typename> class Allocator>
+void LinkedList<Allocator>::Prepend(Bid bid) {
+    // FIXME (3): Implement prepend logic
+    // Create new node
+    Node* node = nodeAllocator.create(bid);
+
+    // if there is already something at the head...
+        // new node points to current head as its next node
+    node->next = head;
+    if (head == nullptr) {
+        tail = node;
+    }
+
+    // head now becomes the new node
+    head = node;
+    byTitle.Insert(&node->bid);
+    //increase size count
+    ++size;
+}
+
+/**
+ * Simple output of all bids in the list
+ */
+template <template <typename> class Allocator>
+void LinkedList<Allocator>::PrintList() {
+    // FIXME (4): Implement print logic
+    // start at the head
+    if (head == nullptr) {
+        cout << "There are no items to print" << endl;
+    }
+    else {
+        Node* temp = head;
+        while (temp != nullptr) {
+            cout << temp->bid.bidId << ": " << temp->bid.title << " | " << temp->bid.amount / 100.0 << " | " << temp->bid.fund << endl;
+            temp = temp->next;
+        }
+    }
+    // whilee, amount and fund
+        //set current equal to next loop over each node looking for a match
+        //output current bidID, titl
+}
+
+/**
+ * Output of all bids in title order, read from the skip list
+ * instead of sorting
+ */
+template <template <typename> class Allocator>
+void LinkedList<Allocator>::PrintSorted() {
+    if (head == nullptr) {
+        cout << "There are no items to print" << endl;
+        return;
+    }
+
+    byTitle.ForEach([](const Bid& bid) {
+        cout << bid.bidId << ": " << bid.title << " | " << bid.amount / 100.0 << " | " << bid.fund << endl;
+    });
+}
+
+/**
+ * Remove a specified bid
+ *
+ * @param bidId The bid id to remove from the list
+ */
+template <template <typename> class Allocator>
+void LinkedList<Allocator>::Remove(string_view bidId) {
+    // FIXME (5): Implement remove logic
+    if (head == nullptr) {
+        cout << "There are no matching nodes in this list. Attempt aborted." << endl;
+        return;
+    }
+
+    // start at the head, prev is the node before current
+    Node* prev = nullptr;
+    for (Node* current = head; current != nullptr; prev = current, current = current->next) {
+        if (current->bid.bidId != bidId) {
+            continue;
+        }
+
+        // unlink it, the head and tail may move
+        if (prev == nullptr) {
+            head = current->next;
+        } else {
+            prev->next = current->next;
+        }
+        if (tail == current) {
+            tail = prev;
+        }
+
+        // now free up memory held by the node and decrease size count
+        byTitle.Remove(&current->bid);
+        nodeAllocator.destroy(current);
+        --size;
+        cout << "Record has been found and deleted" << endl;
+        return;
+    }
+
+    cout << "No record with that ID number exists" << endl;
+}
+
+/**
+ * Search for the specified bidId, without copying the key
+ * or the bid
+ *
+ * @param bidId The bid id to search for
+ * @return the bid in the list, or nullptr when absent; it
+ *         stays valid until the bid is removed
+ */
+template <template <typename> class Allocator>
+const Bid* LinkedList<Allocator>::Search(string_view bidId) const {
+    // FIXME (6): Implement search logic
+
+    // special case if matching bid is the head
+    const Node* temp = head;
+    if (temp == nullptr) {
+        cout << "No nodes in this list. Search aborted" << endl;
+        return nullptr;
+    }
+    else {
+        while (temp != nullptr) {
+            if (temp->bid.bidId == bidId) {
+                return &temp->bid;
+            }
+            temp = temp->next;
+        }
+    }
+    return nullptr;
+    // start at the head of the list
+
+    // keep searching until end reached with while loop (current != nullptr)
+        // if the current node matches, return current bid
+        // else current node is equal to next node
+
+    //(the next two statements will only execute if search item is not found)
+        //create new empty bid
+        //return empty bid 
+}
+
+/**
+ * Returns the current size (number of elements) in the list
+ */
+template <template <typename> class Allocator>
+int LinkedList<Allocator>::Size() {
+    return size;
+}
+
+//============================================================================
+// Static methods used for testing
+//============================================================================
+
+/**
+ * Display the bid information
+ *
+ * @param bid struct containing the bid info
+ */
+void displayBid(const Bid& bid) {
+    cout << bid.bidId << ": " << bid.title << " | " << bid.amount / 100.0
+         << " | " << bid.fund << endl;
+    return;
+}
+
+/**
+ * Prompt user for bid information
+ *
+ * @return Bid struct containing the bid info
+ */
+Bid getBid() {
+    Bid bid;
+
+    cout << "Enter Id: ";
+    cin.ignore();
+    getline(cin, bid.bidId);
+
+    cout << "Enter title: ";
+    getline(cin, bid.title);
+
+    cout << "Enter fund: ";
+    cin >> bid.fund;
+
+    cout << "Enter amount: ";
+    cin.ignore();
+    string strAmount;
+    while (getline(cin, strAmount) && !csv::toCents(strAmount, bid.amount)) {
+        cout << "Enter amount in dollars: ";
+    }
+
+    return bid;
+}
+
+// CSV columns a bid is built from: title, id, winning bid and fund
+const csv::Columns BID_COLUMNS = { 0, 1, 4, 8 };
+
+/**
+ * Build a bid from the current row of a CSV cursor
+ * projected on BID_COLUMNS
+ *
+ * @param row cursor positioned on a data row
+ * @return Bid struct containing the bid info, empty when the
+ *         winning bid can't be read
+ */
+optional<Bid> parseBid(const csv::Cursor& row) {
+    Bid bid;
+    bid.bidId = row.unquote(1);
+    bid.title = row.unquote(0);
+    bid.fund = row.unquote(3);
+    if (!csv::toCents(row[2], bid.amount)) {
+        return nullopt;
+    }
+    return bid;
+}
+
+/**
+ * Parse the bids of a mapped CSV file on all cores, they come
+ * back in file order. Rows whose winning bid can't be read are
+ * skipped and counted.
+ *
+ * @param file the mapped CSV file
+ * @return the bids read
+ */
+vector<Bid> parseBids(const csv::MappedFile& file) {
+    vector<optional<Bid>> rows = csv::parallelLoad<optional<Bid>>(file, parseBid, BID_COLUMNS);
+
+    vector<Bid> bids;
+    bids.reserve(rows.size());
+    for (auto& row : rows) {
+        if (row) {
+            bids.push_back(move(*row));
+        }
+    }
+    if (bids.size() != rows.size()) {
+        cout << rows.size() - bids.size() << " rows skipped, their winning bid can't be read" << endl;
+    }
+    return bids;
+}
+
+/**
+ * Load bids from the binary snapshot of a CSV file
+ *
+ * @param csvPath the path to the CSV file the snapshot was made from
+ * @param bids vector receiving the bids
+ * @return true when an up to date snapshot was found
+ */
+bool loadSnapshot(string csvPath, vector<Bid>& bids) {
+    try {
+        snapshot::Reader snap(snapshot::pathFor(csvPath));
+        if (!snap.fresh(csvPath)) {
+            return false;
+        }
+
+        bids.reserve(snap.size());
+        for (unsigned int i = 0; i < snap.size(); ++i) {
+            Bid bid;
+            bid.bidId = snap.bidId(i);
+            bid.title = snap.title(i);
+            bid.fund = snap.fund(i);
+            bid.amount = snap.amount(i);
+            bids.push_back(bid);
+        }
+    } catch (snapshot::Error &e) {
+        bids.clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Save bids read from a CSV file to its binary snapshot
+ *
+ * @param csvPath the path to the CSV file the bids were read from
+ * @param bids the bids to save
+ */
+void saveSnapshot(string csvPath, const vector<Bid>& bids) {
+    snapshot::Writer writer;
+    try {
+        for (auto const& bid : bids) {
+            writer.add(bid.bidId, bid.title, bid.fund.str(), bid.amount);
+        }
+        writer.write(snapshot::pathFor(csvPath), csvPath);
+    } catch (snapshot::Error &e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+/**
+ * Load a CSV file containing bids into a LinkedList
+ *
+ * @return a LinkedList containing all the bids read
+ */
+void loadBids(string csvPath, LinkedList<> *list) {
+    cout << "Loading CSV file " << csvPath << endl;
+
+    vector<Bid> bids;
+
+    // reuse the binary snapshot while it matches the CSV file
+    if (!loadSnapshot(csvPath, bids)) {
+        try {
+            // map the CSV file and parse the rows on all cores,
+            // they come back in file order
+            csv::MappedFile file(csvPath);
+            bids = parseBids(file);
+            saveSnapshot(csvPath, bids);
+        } catch (csv::Error &e) {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+
+    for (auto const& bid : bids) {
+        // add this bid to the end
+        list->Append(bid);
+    }
+}
+
+/**
+ * The one and only main() method
+ *
+ * @param arg[1] path to CSV file to load from (optional)
+ * @param arg[2] the bid Id to use when searching the list (optional)
+ */
+int main(int argc, char* argv[]) {
+
+    // process command line arguments
+    string csvPath, bidKey;
+    switch (argc) {
+    case 2:
+        csvPath = argv[1];
+        bidKey = "98109";
+        break;
+    case 3:
+        csvPath = argv[1];
+        bidKey = argv[2];
+        break;
+    default:
+        csvPath = "eBid_Monthly_Sales.csv";
+        bidKey = "98109";
+    }
+
+    clock_t ticks;
+
+    LinkedList<> bidList;
+
+    Bid bid;
+    const Bid* found = nullptr;
+
+    int choice = 0;
+    while (choice != 9) {
+        cout << "Menu:" << endl;
+        cout << "  1. Enter a Bid" << endl;
+        cout << "  2. Load Bids" << endl;
+        cout << "  3. Display All Bids" << endl;
+        cout << "  4. Find Bid" << endl;
+        cout << "  5. Remove Bid" << endl;
+        cout << "  6. Display All Bids By Title" << endl;
+        cout << "  9. Exit" << endl;
+        cout << "Enter choice: ";
+        cin >> choice;
+
+        switch (choice) {
+        case 1:
+            bid = getBid();
+            bidList.Append(bid);
+            displayBid(bid);
+
+            break;
+
+        case 2:
+            ticks = clock();
+
+            loadBids(csvPath, &bidList);
+
+            cout << bidList.Size() << " bids read" << endl;
+
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+            cout << "time: " << ticks << " milliseconds" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+            break;
+
+        case 3:
+            bidList.PrintList();
+
+            break;
+
+        case 4:
+            ticks = clock();
+
+            found = bidList.Search(bidKey);
+
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+
+            if (found != nullptr) {
+                displayBid(*found);
+            } else {
+            	cout << "Bid Id " << bidKey << " not found." << endl;
+            }
+
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+            break;
+
+        case 5:
+            bidList.Remove(bidKey);
+
+            break;
+
+        case 6:
+            bidList.PrintSorted();
+
+            break;
+        }
+    }
+
+    cout << "Good bye." << endl;
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+#ifndef     _NODEPOOL_HPP_
+# define    _NODEPOOL_HPP_
+
+# include <cstddef>
+# include <new>
+# include <type_traits>
+# include <utility>
+# include <vector>
+
+/*
+** Node allocators for the linked containers. A container takes one as a
+** template template parameter and only uses :
+**
+**   T *create(args...)     construct a node
+**   void destroy(T *)      destroy one node
+**   RELEASES_ALL           true when destroying the allocator also
+**                          destroys every node still allocated, so the
+**                          container does not need to walk its nodes
+*/
+namespace pool
+{
+    /*
+    ** Bump allocator over chunks of nodes, destroyed nodes go on a free
+    ** list and are reused first. Chunks double from 64 up to 4096 nodes,
+    ** so a bulk load makes a handful of allocations and teardown frees
+    ** one block per chunk. Teardown is O(chunks) only for trivially
+    ** destructible nodes: otherwise every live node's destructor still
+    ** runs, in one linear sweep over the chunks, and whatever the nodes
+    ** own (a Bid's strings) is freed one block at a time as before.
+    */
+    template <typename T>
+    class Arena
+    {
+
+    public:
+        static const bool RELEASES_ALL = true;
+
+        Arena(void) : _used(0), _free(nullptr)
+        {
+        }
+
+        ~Arena(void)
+        {
+            for (std::size_t c = 0; c < _chunks.size(); ++c)
+            {
+                Slot *slots = _chunks[c].slots;
+                std::size_t used = c + 1 == _chunks.size() ? _used : _chunks[c].size;
+
+                if (!std::is_trivially_destructible<T>::value)
+                    for (std::size_t i = 0; i < used; ++i)
+                        if (slots[i].live)
+                            slots[i].value()->~T();
+                ::operator delete(slots);
+            }
+        }
+
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        template <typename... Args>
+        T *create(Args &&... args)
+        {
+            Slot *slot = _free;
+
+            if (slot != nullptr)
+                _free = slot->nextFree;
+            else
+            {
+                if (_chunks.empty() || _used == _chunks.back().size)
+                    addChunk();
+                slot = &_chunks.back().slots[_used++];
+            }
+            T *node = new (slot->storage) T(std::forward<Args>(args)...);
+            slot->live = true;
+            return node;
+        }
+
+        void destroy(T *node)
+        {
+            // storage is the first member, so a node is its slot
+            Slot *slot = reinterpret_cast<Slot *>(node);
+
+            node->~T();
+            slot->live = false;
+            slot->nextFree = _free;
+            _free = slot;
+        }
+
+        std::size_t chunkCount(void) const
+        {
+            return _chunks.size();
+        }
+
+    private:
+        struct Slot
+        {
+            alignas(T) unsigned char storage[sizeof(T)];
+            Slot *nextFree;
+            bool live;
+
+            T *value(void)
+            {
+                return reinterpret_cast<T *>(storage);
+            }
+        };
+
+        struct Chunk
+        {
+            Slot *slots;
+            std::size_t size;
+        };
+
+        void addChunk(void)
+        {
+            std::size_t size = _chunks.empty() ? 64 : _chunks.back().size * 2;
+
+            if (size > 4096)
+                size = 4096;
+            _chunks.push_back(Chunk{ static_cast<Slot *>(::operator new(size * sizeof(Slot))), size });
+            _used = 0;
+        }
+
+        std::vector<Chunk> _chunks;
+        std::size_t _used;      // slots handed out from the last chunk
+        Slot *_free;
+    };
+
+    /*
+    ** One heap allocation per node, what new/delete did before; kept to
+    ** compare against Arena.
+    */
+    template <typename T>
+    class Heap
+    {
+
+    public:
+        static const bool RELEASES_ALL = false;
+
+        template <typename... Args>
+        T *create(Args &&... args)
+        {
+            return new T(std::forward<Args>(args)...);
+        }
+
+        void destroy(T *node)
+        {
+            delete node;
+        }
+    };
+}
+
+#endif /*!_NODEPOOL_HPP_*/
@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <climits>
+#include <deque>
+#include <unordered_map>
+#include "BidReport.hpp"
+
+namespace report {
+
+  /*
+  ** AGGREGATE
+  */
+
+  Aggregate::Aggregate(void)
+      : rows(0), count(0), sum(0), min(LLONG_MAX), max(LLONG_MIN) {}
+
+  void Aggregate::add(long long value)
+  {
+      count++;
+      sum += value;
+      min = std::min(min, value);
+      max = std::max(max, value);
+  }
+
+  void Aggregate::merge(const Aggregate &other)
+  {
+      rows += other.rows;
+      count += other.count;
+      sum += other.sum;
+      min = std::min(min, other.min);
+      max = std::max(max, other.max);
+  }
+
+  double Aggregate::average(void) const
+  {
+      return count ? static_cast<double>(sum) / count : 0.0;
+  }
+
+  /*
+  ** GROUP BY
+  */
+
+  // index of a column given by name or number, header is on its first row
+  static unsigned int findColumn(const csv::Cursor &header, const std::string &spec)
+  {
+      unsigned int index;
+
+      if (!csv::findColumn(header, spec, index))
+          throw Error(std::string("no column ").append(spec));
+      return index;
+  }
+
+  // what one chunk folds to; unquoted keys are kept in keys so the
+  // map can hold views of them
+  struct Partial
+  {
+      std::unordered_map<std::string_view, Aggregate> groups;
+      std::deque<std::string> keys;
+  };
+
+  std::vector<Group> groupBy(const csv::MappedFile &file, const std::string &keyColumn,
+                             const std::string &valueColumn, char sep, unsigned int threads)
+  {
+      csv::Cursor names(file, sep);
+      if (!names.next())
+          return std::vector<Group>();
+
+      unsigned int key = findColumn(names, keyColumn);
+      bool counting = valueColumn.empty();
+      unsigned int value = counting ? key : findColumn(names, valueColumn);
+
+      // projected fields come out in file order
+      csv::Columns columns = (key == value) ? csv::Columns{ key }
+                                            : csv::Columns{ std::min(key, value), std::max(key, value) };
+      unsigned int keyField = key <= value ? 0 : 1;
+      unsigned int valueField = value <= key ? 0 : 1;
+
+      std::vector<Partial> partials = csv::forEachChunk<Partial>(file,
+          [=](Partial &partial, csv::Cursor &row)
+          {
+              while (row.next())
+              {
+                  std::string_view name = row[keyField];
+                  auto it = partial.groups.end();
+
+                  if (!name.empty() && name.front() == '"')
+                  {
+                      std::string unquoted = row.unquote(keyField);
+                      it = partial.groups.find(unquoted);
+                      if (it == partial.groups.end())
+                      {
+                          partial.keys.push_back(unquoted);
+                          it = partial.groups.emplace(partial.keys.back(), Aggregate()).first;
+                      }
+                  }
+                  else
+                      it = partial.groups.try_emplace(name).first;
+
+                  Aggregate &group = it->second;
+                  long long amount;
+                  group.rows++;
+                  if (!counting && csv::toCents(row[valueField], amount))
+                      group.add(amount);
+              }
+          },
+          columns, sep, threads);
+
+      std::unordered_map<std::string_view, Aggregate> merged;
+      for (auto &partial : partials)
+          for (auto &group : partial.groups)
+              merged[group.first].merge(group.second);
+
+      std::vector<Group> groups;
+      groups.reserve(merged.size());
+      for (auto &group : merged)
+          groups.push_back(Group{ std::string(group.first), group.second });
+      std::sort(groups.begin(), groups.end(),
+                [](const Group &a, const Group &b) { return a.key < b.key; });
+      return groups;
+  }
+}
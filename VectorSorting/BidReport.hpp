@@ -0,0 +1,67 @@
+#ifndef     _BIDREPORT_HPP_
+# define    _BIDREPORT_HPP_
+
+# include <cstddef>
+# include <stdexcept>
+# include <string>
+# include <vector>
+
+# include "CSVparser.hpp"
+
+/*
+** Group-by aggregation over the rows of a CSV export, e.g. total
+** winning bid per fund or number of bids per department.
+**
+** A Bid only keeps four of the columns, so the engine reads the mapped
+** file itself and can key on any of them. It makes a single pass: the
+** rows are cut into chunks by csv::forEachChunk, like parallelLoad,
+** every chunk is folded into its own hash map keyed by the raw field
+** bytes, and the maps are merged once all threads are done.
+*/
+namespace report
+{
+    class Error : public std::runtime_error
+    {
+
+      public:
+        Error(const std::string &msg):
+          std::runtime_error(std::string("BidReport : ").append(msg))
+        {
+        }
+    };
+
+    /*
+    ** Running totals of one group. rows counts every row of the group,
+    ** the other members only the rows whose value parsed as an amount.
+    */
+    struct Aggregate
+    {
+        std::size_t rows;
+        std::size_t count;
+        long long sum;
+        long long min;
+        long long max;
+
+        Aggregate(void);
+        void add(long long value);
+        void merge(const Aggregate &other);
+        double average(void) const;
+    };
+
+    struct Group
+    {
+        std::string key;
+        Aggregate values;
+    };
+
+    /*
+    ** Columns are given by header name (surrounding blanks and case
+    ** ignored) or by 0 based index. An empty valueColumn only counts
+    ** rows. Groups come back sorted by key.
+    */
+    std::vector<Group> groupBy(const csv::MappedFile &file, const std::string &keyColumn,
+                               const std::string &valueColumn, char sep = ',',
+                               unsigned int threads = 0);
+}
+
+#endif /*!_BIDREPORT_HPP_*/
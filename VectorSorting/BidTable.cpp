@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <climits>
+#include "BidTable.hpp"
+
+/*
+** FILTER
+*/
+
+BidTable::Filter::Filter(void)
+    : minAmount(LLONG_MIN), maxAmount(LLONG_MAX), fundCode(ANY_FUND) {}
+
+/*
+** BIDTABLE
+*/
+
+BidTable::BidTable(void)
+{
+    _offsets.push_back(0);
+}
+
+void BidTable::reserve(std::size_t bids, std::size_t textBytes)
+{
+    _amount.reserve(bids);
+    _fund.reserve(bids);
+    _offsets.reserve(2 * bids + 1);
+    _text.reserve(textBytes);
+}
+
+void BidTable::append(std::string_view bidId, std::string_view title,
+                      const csv::Symbol &fund, long long amount)
+{
+    // funds are few, a linear search of the dictionary is enough
+    std::uint32_t code = fundCode(fund);
+    if (code == NO_FUND)
+    {
+        code = static_cast<std::uint32_t>(_funds.size());
+        _funds.push_back(fund);
+    }
+
+    _amount.push_back(amount);
+    _fund.push_back(code);
+    _text.append(bidId.data(), bidId.size());
+    _offsets.push_back(static_cast<std::uint32_t>(_text.size()));
+    _text.append(title.data(), title.size());
+    _offsets.push_back(static_cast<std::uint32_t>(_text.size()));
+}
+
+void BidTable::clear(void)
+{
+    _amount.clear();
+    _fund.clear();
+    _funds.clear();
+    _offsets.assign(1, 0);
+    _text.clear();
+}
+
+std::size_t BidTable::size(void) const
+{
+    return _amount.size();
+}
+
+std::string_view BidTable::bidId(std::size_t i) const
+{
+    return std::string_view(_text.data() + _offsets[2 * i], _offsets[2 * i + 1] - _offsets[2 * i]);
+}
+
+std::string_view BidTable::title(std::size_t i) const
+{
+    return std::string_view(_text.data() + _offsets[2 * i + 1], _offsets[2 * i + 2] - _offsets[2 * i + 1]);
+}
+
+const csv::Symbol &BidTable::fund(std::size_t i) const
+{
+    return _funds[_fund[i]];
+}
+
+long long BidTable::amount(std::size_t i) const
+{
+    return _amount[i];
+}
+
+const std::vector<csv::Symbol> &BidTable::funds(void) const
+{
+    return _funds;
+}
+
+std::uint32_t BidTable::fundCode(const csv::Symbol &fund) const
+{
+    for (std::size_t code = 0; code < _funds.size(); code++)
+        if (_funds[code] == fund)
+            return static_cast<std::uint32_t>(code);
+    return NO_FUND;
+}
+
+/*
+** SCANS
+**
+** The loops below have no data dependent branches: every row is
+** tested and its amount blended in through an all-ones/all-zeros
+** mask, which compilers turn into SIMD compares and ands.
+*/
+
+BidTable::Stats BidTable::scan(const Filter &filter) const
+{
+    const long long *amount = _amount.data();
+    const std::uint32_t *fund = _fund.data();
+    const std::size_t n = _amount.size();
+    // a zero mask makes every fund compare equal
+    const std::uint32_t fundMask = filter.fundCode == ANY_FUND ? 0 : 0xffffffffu;
+    const std::uint32_t fundCode = filter.fundCode & fundMask;
+
+    long long count = 0;
+    long long sum = 0;
+    long long min = LLONG_MAX;
+    long long max = LLONG_MIN;
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+        long long a = amount[i];
+        // all ones when the row is kept, else zero
+        long long keep = -static_cast<long long>((a >= filter.minAmount) & (a <= filter.maxAmount)
+                                                 & ((fund[i] & fundMask) == fundCode));
+
+        count -= keep;
+        sum += a & keep;
+        long long low = (a & keep) | (LLONG_MAX & ~keep);
+        long long high = (a & keep) | (LLONG_MIN & ~keep);
+        min = low < min ? low : min;
+        max = high > max ? high : max;
+    }
+
+    Stats stats;
+    stats.count = static_cast<std::size_t>(count);
+    stats.sum = sum;
+    stats.min = min;
+    stats.max = max;
+    return stats;
+}
+
+long long BidTable::sum(const Filter &filter) const
+{
+    const long long *amount = _amount.data();
+    const std::uint32_t *fund = _fund.data();
+    const std::size_t n = _amount.size();
+    const std::uint32_t fundMask = filter.fundCode == ANY_FUND ? 0 : 0xffffffffu;
+    const std::uint32_t fundCode = filter.fundCode & fundMask;
+
+    long long sum = 0;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        long long a = amount[i];
+        long long keep = -static_cast<long long>((a >= filter.minAmount) & (a <= filter.maxAmount)
+                                                 & ((fund[i] & fundMask) == fundCode));
+        sum += a & keep;
+    }
+    return sum;
+}
+
+// row numbers of the matching bids, in table order
+std::vector<std::uint32_t> BidTable::select(const Filter &filter) const
+{
+    const long long *amount = _amount.data();
+    const std::uint32_t *fund = _fund.data();
+    const std::size_t n = _amount.size();
+    const std::uint32_t fundMask = filter.fundCode == ANY_FUND ? 0 : 0xffffffffu;
+    const std::uint32_t fundCode = filter.fundCode & fundMask;
+
+    std::vector<std::uint32_t> rows(n);
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        long long a = amount[i];
+        bool keep = (a >= filter.minAmount) & (a <= filter.maxAmount)
+                    & ((fund[i] & fundMask) == fundCode);
+
+        // always write, only advance past kept rows
+        rows[count] = static_cast<std::uint32_t>(i);
+        count += keep;
+    }
+    rows.resize(count);
+    return rows;
+}
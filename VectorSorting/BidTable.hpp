@@ -0,0 +1,82 @@
+#ifndef     _BIDTABLE_HPP_
+# define    _BIDTABLE_HPP_
+
+# include <cstddef>
+# include <cstdint>
+# include <string>
+# include <string_view>
+# include <vector>
+
+# include "CSVparser.hpp"
+
+/*
+** Column store of bids (structure of arrays). Each field lives in its
+** own contiguous array so a scan over amounts only reads amounts :
+**
+**   amount[]   winning bid in cents
+**   fund[]     code into the table's fund dictionary
+**   text       one string heap holding every id and title back to
+**              back, located through offsets[] (2 per bid + 1)
+*/
+class BidTable
+{
+
+public:
+    // fund code matching every fund in a filter
+    static const std::uint32_t ANY_FUND = 0xffffffffu;
+    // fund code of a fund not in the table, matches no bid
+    static const std::uint32_t NO_FUND = 0xfffffffeu;
+
+    /*
+    ** Rows kept by a scan: amount in [minAmount, maxAmount] and
+    ** fund equal to fundCode unless it is ANY_FUND.
+    */
+    struct Filter
+    {
+        long long minAmount;
+        long long maxAmount;
+        std::uint32_t fundCode;
+
+        Filter(void);
+    };
+
+    struct Stats
+    {
+        std::size_t count;
+        long long sum;
+        long long min;      // only meaningful when count > 0
+        long long max;
+    };
+
+public:
+    BidTable(void);
+
+public:
+    void reserve(std::size_t bids, std::size_t textBytes = 0);
+    void append(std::string_view bidId, std::string_view title,
+                const csv::Symbol &fund, long long amount);
+    void clear(void);
+
+    std::size_t size(void) const;
+    std::string_view bidId(std::size_t) const;
+    std::string_view title(std::size_t) const;
+    const csv::Symbol &fund(std::size_t) const;
+    long long amount(std::size_t) const;
+
+    const std::vector<csv::Symbol> &funds(void) const;
+    std::uint32_t fundCode(const csv::Symbol &) const;
+
+    // scan primitives, branch free loops the compiler can vectorize
+    Stats scan(const Filter &) const;
+    long long sum(const Filter &) const;
+    std::vector<std::uint32_t> select(const Filter &) const;
+
+private:
+    std::vector<long long> _amount;
+    std::vector<std::uint32_t> _fund;
+    std::vector<csv::Symbol> _funds;
+    std::vector<std::uint32_t> _offsets;
+    std::string _text;
+};
+
+#endif /*!_BIDTABLE_HPP_*/
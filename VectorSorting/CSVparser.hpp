@@ -1,8 +1,15 @@
 #ifndef     _CSVPARSER_HPP_
 # define    _CSVPARSER_HPP_
 
+# include <atomic>
+# include <exception>
+# include <initializer_list>
 # include <stdexcept>
+# include <fstream>
 # include <string>
+# include <string_view>
+# include <thread>
+# include <utility>
 # include <vector>
 # include <list>
 # include <sstream>
@@ -19,6 +26,38 @@ namespace csv
         }
     };
 
+    /*
+    ** Column projection : the columns a caller wants, by index or by
+    ** header name. Readers built with a projection only materialize
+    ** the selected fields, in file order, and skip over the others.
+    */
+    class Columns
+    {
+    	public:
+    	    Columns(void);
+    	    Columns(std::initializer_list<unsigned int>);
+    	    Columns(const std::vector<std::string> &);
+
+    	public:
+            void resolve(const std::vector<std::string> &);
+            bool resolved(void) const;
+            bool all(void) const;
+            std::vector<std::string> project(const std::vector<std::string> &) const;
+
+    	private:
+    		std::vector<unsigned int> _indices;
+    		std::vector<std::string> _names;
+    		std::vector<bool> _mask;
+    		bool _all;
+    		bool _resolved;
+
+        public:
+            bool selects(unsigned int column) const
+            {
+                return _all || (column < _mask.size() && _mask[column]);
+            }
+    };
+
     class Row
     {
     	public:
@@ -28,6 +67,7 @@ namespace csv
     	public:
             unsigned int size(void) const;
             void push(const std::string &);
+            void clear(void);
             bool set(const std::string &, const std::string &); 
 
     	private:
@@ -64,7 +104,8 @@ namespace csv
     {
 
     public:
-        Parser(const std::string &, const DataType &type = eFILE, char sep = ',');
+        Parser(const std::string &, const DataType &type = eFILE, char sep = ',',
+               const Columns &columns = Columns());
         ~Parser(void);
 
     public:
@@ -88,6 +129,8 @@ namespace csv
         std::string _file;
         const DataType _type;
         const char _sep;
+        Columns _columns;
+        unsigned int _width;
         std::vector<std::string> _originalFile;
         std::vector<std::string> _header;
         std::vector<Row *> _content;
@@ -95,6 +138,241 @@ namespace csv
     public:
         Row &operator[](unsigned int row) const;
     };
+
+    /*
+    ** Read-only memory mapping of a whole file.
+    */
+    class MappedFile
+    {
+
+    public:
+        MappedFile(const std::string &);
+        ~MappedFile(void);
+
+    public:
+        const char *data(void) const;
+        std::size_t size(void) const;
+        const std::string &getFileName(void) const;
+
+    private:
+        MappedFile(const MappedFile &);
+        MappedFile &operator=(const MappedFile &);
+
+    private:
+        std::string _file;
+        const char *_data;
+        std::size_t _size;
+# ifdef _WIN32
+        void *_handle;
+        void *_mapping;
+# endif
+    };
+
+    std::string unquote(std::string_view);
+
+    /*
+    ** Record scanner check and benchmark. countSeparators walks every
+    ** record of a file and counts its unquoted separators, with the
+    ** scanner the parsers use or, when bytes is true, with the byte at a
+    ** time loop (the scanner of CSVPARSER_NO_SIMD builds). scannerName
+    ** is the scanner's instruction set: "AVX2", "SSE2" or "scalar".
+    */
+    std::size_t countSeparators(const MappedFile &, char sep, bool bytes);
+    const char *scannerName(void);
+
+    /*
+    ** Zero-copy row cursor over a byte range (usually a MappedFile).
+    ** Fields are string_views into the buffer and stay valid as long
+    ** as the buffer does; quotes are only unescaped by unquote().
+    */
+    class Cursor
+    {
+
+    public:
+        Cursor(const char *begin, const char *end, char sep = ',',
+               unsigned int width = 0, const Columns &columns = Columns());
+        Cursor(const MappedFile &, char sep = ',', const Columns &columns = Columns());
+
+    public:
+        bool next(void);
+        unsigned int size(void) const;
+        unsigned int columnCount(void) const;
+        const Columns &columns(void) const;
+        std::string unquote(unsigned int) const;
+        const char *position(void) const;
+
+    private:
+        const char *_pos;
+        const char *_end;
+        const char _sep;
+        unsigned int _width;
+        Columns _columns;
+        std::vector<std::string_view> _fields;
+
+    public:
+        std::string_view operator[](unsigned int) const;
+    };
+
+    /*
+    ** Index of a column given by header name (surrounding blanks and
+    ** case ignored) or by 0 based index, header being a cursor on the
+    ** header row. Returns false when there is no such column.
+    */
+    bool findColumn(const Cursor &header, const std::string &spec, unsigned int &index);
+
+    /*
+    ** Typed decoders, reading straight from the raw field bytes (quotes
+    ** and surrounding blanks included) without a temporary string.
+    ** They return false and leave the output untouched when the field
+    ** doesn't hold a valid value.
+    */
+    struct Date
+    {
+        int year;
+        int month;
+        int day;
+    };
+
+    bool toInteger(std::string_view, long long &);
+    bool toCents(std::string_view, long long &);
+    bool toDate(std::string_view, Date &);
+
+    /*
+    ** Interned string for low cardinality fields. Equal strings share
+    ** one copy kept for the life of the program, so a Symbol is just a
+    ** pointer to it: copies don't allocate and == compares pointers.
+    ** Interning is thread safe, parallelLoad converters may use it.
+    */
+    class Symbol
+    {
+
+    public:
+        Symbol(void);
+        Symbol(std::string_view);
+        Symbol(const std::string &);
+        Symbol(const char *);
+
+    public:
+        const std::string &str(void) const { return *_value; }
+        bool empty(void) const { return _value->empty(); }
+        bool operator==(const Symbol &other) const { return _value == other._value; }
+        bool operator!=(const Symbol &other) const { return _value != other._value; }
+        // orders by text, not by address
+        bool operator<(const Symbol &other) const { return *_value < *other._value; }
+
+        static std::size_t distinctCount(void);
+
+    private:
+        const std::string *_value;
+    };
+
+    std::ostream &operator<<(std::ostream &, const Symbol &);
+    std::istream &operator>>(std::istream &, Symbol &);
+
+    typedef std::pair<const char *, const char *> Chunk;
+
+    std::vector<Chunk> split(const char *begin, const char *end, unsigned int count);
+
+    /*
+    ** Walks every data row of a mapped file on a pool of threads. The
+    ** rows after the header are cut into chunks at record boundaries, a
+    ** few per thread so a slow chunk doesn't stall the pool, and each
+    ** chunk gets its own R: fn(R &, Cursor &rows) is called once per
+    ** chunk with a cursor over its rows. The results come back in file
+    ** order, none when the file has no header. The projection, if any,
+    ** is resolved against the header. An exception thrown by fn is
+    ** rethrown once every thread has stopped.
+    */
+    template<typename R, typename F>
+    std::vector<R> forEachChunk(const MappedFile &file, F fn,
+                                const Columns &columns = Columns(), char sep = ',',
+                                unsigned int threads = 0)
+    {
+        static const std::size_t MIN_CHUNK = 1 << 20;
+
+        Cursor header(file, sep, columns);
+        if (!header.next())
+            return std::vector<R>();
+
+        const char *begin = header.position();
+        const char *end = file.data() + file.size();
+
+        if (threads == 0)
+            threads = std::thread::hardware_concurrency();
+        if (threads == 0)
+            threads = 1;
+
+        std::size_t wanted = (end - begin) / MIN_CHUNK + 1;
+        if (wanted > threads * 4)
+            wanted = threads * 4;
+        std::vector<Chunk> chunks = split(begin, end, wanted);
+        if (threads > chunks.size())
+            threads = chunks.empty() ? 1 : static_cast<unsigned int>(chunks.size());
+
+        std::vector<R> results(chunks.size());
+        std::vector<std::exception_ptr> errors(threads);
+        std::atomic<std::size_t> nextChunk(0);
+
+        auto work = [&](unsigned int worker)
+        {
+            try
+            {
+                std::size_t i;
+                while ((i = nextChunk++) < chunks.size())
+                {
+                    Cursor rows(chunks[i].first, chunks[i].second, sep,
+                                header.columnCount(), header.columns());
+                    fn(results[i], rows);
+                }
+            }
+            catch (...)
+            {
+                errors[worker] = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned int t = 1; t < threads; t++)
+            pool.emplace_back(work, t);
+        work(0);
+        for (auto &thread : pool)
+            thread.join();
+        for (auto &error : errors)
+            if (error)
+                std::rethrow_exception(error);
+        return results;
+    }
+
+    /*
+    ** Parses every data row of a mapped file on a pool of threads (see
+    ** forEachChunk): convert(const Cursor &) is called once per row and
+    ** the values it returns come back in file order.
+    */
+    template<typename T, typename F>
+    std::vector<T> parallelLoad(const MappedFile &file, F convert,
+                                const Columns &columns = Columns(), char sep = ',',
+                                unsigned int threads = 0)
+    {
+        std::vector<std::vector<T> > parts = forEachChunk<std::vector<T> >(file,
+            [&convert](std::vector<T> &part, Cursor &rows)
+            {
+                while (rows.next())
+                    part.push_back(convert(rows));
+            },
+            columns, sep, threads);
+
+        // merge the chunks back in file order
+        std::size_t total = 0;
+        for (auto &part : parts)
+            total += part.size();
+
+        std::vector<T> result;
+        result.reserve(total);
+        for (auto &part : parts)
+            for (auto &value : part)
+                result.push_back(std::move(value));
+        return result;
+    }
 }
 
 #endif /*!_CSVPARSER_HPP_*/
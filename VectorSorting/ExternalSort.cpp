@@ -0,0 +1,431 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "CSVparser.hpp"
+#include "ExternalSort.hpp"
+
+namespace external {
+
+  // most runs merged at once, bounds the open files and the buffers
+  static const std::size_t MAX_FAN_IN = 128;
+  // smallest stream buffer of a run while merging
+  static const std::size_t MIN_BUFFER = 1 << 16;
+  // smallest budget honoured, below it every row would be its own run
+  static const std::size_t MIN_BUDGET = 1 << 20;
+
+  Options::Options(void)
+    : memoryBudget(64 << 20), tempDir(), keyType(eTEXT), sep(',') {}
+
+  /*
+  ** KEYS
+  */
+
+  static void appendBigEndian(std::string &key, std::uint64_t value)
+  {
+      for (int shift = 56; shift >= 0; shift -= 8)
+          key.push_back(static_cast<char>(value >> shift));
+  }
+
+  // bytewise comparable key of a field; numbers and dates that parse
+  // get a 1 byte tag so they sort after those that don't
+  static void makeKey(std::string_view field, KeyType type, std::string &key)
+  {
+      long long cents;
+      csv::Date date;
+
+      key.clear();
+      switch (type)
+      {
+      case eNUMBER:
+          if (csv::toCents(field, cents))
+          {
+              key.push_back('\1');
+              appendBigEndian(key, static_cast<std::uint64_t>(cents) ^ (1ULL << 63));
+          }
+          break;
+      case eDATE:
+          if (csv::toDate(field, date) && date.year >= 0)
+          {
+              key.push_back('\1');
+              appendBigEndian(key, static_cast<std::uint64_t>(date.year) * 10000
+                                   + date.month * 100 + date.day);
+          }
+          break;
+      default:
+          key = csv::unquote(field);
+      }
+  }
+
+  // the raw bytes of the current record, line break excluded
+  static std::string_view record(const csv::Cursor &row)
+  {
+      std::string_view first = row[0];
+      std::string_view last = row[row.size() - 1];
+
+      return std::string_view(first.data(), last.data() + last.size() - first.data());
+  }
+
+  /*
+  ** TEMPORARY FILES
+  */
+
+  // run files of one sort, removed when it ends however it ends
+  class TempFiles
+  {
+
+  public:
+      TempFiles(const std::string &dir) : _count(0)
+      {
+          std::error_code ec;
+
+          _dir = dir.empty() ? std::filesystem::temp_directory_path(ec) : std::filesystem::path(dir);
+          if (ec || !std::filesystem::is_directory(_dir, ec))
+              throw Error(std::string("no temporary directory ").append(_dir.string()));
+          _prefix = "bidsort-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+      }
+
+      ~TempFiles(void)
+      {
+          for (auto &path : _paths)
+              remove(path);
+      }
+
+      std::string create(void)
+      {
+          _paths.push_back((_dir / (_prefix + "-" + std::to_string(_count++) + ".run")).string());
+          return _paths.back();
+      }
+
+      void remove(const std::string &path)
+      {
+          std::error_code ec;
+          std::filesystem::remove(path, ec);
+      }
+
+  private:
+      std::filesystem::path _dir;
+      std::string _prefix;
+      std::size_t _count;
+      std::vector<std::string> _paths;
+  };
+
+  /*
+  ** RUNS
+  */
+
+  // buffered binary stream; the buffer must be set before opening
+  template <typename Stream>
+  static void open(Stream &stream, std::vector<char> &buffer, const std::string &path,
+                   std::ios::openmode mode)
+  {
+      stream.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+      stream.open(path.c_str(), mode | std::ios::binary);
+      if (!stream.is_open())
+          throw Error(std::string("Failed to open ").append(path));
+  }
+
+  // run record: key size, row size, key, row
+  static void writeRecord(std::ofstream &out, std::string_view key, std::string_view row)
+  {
+      std::uint32_t sizes[2] = { static_cast<std::uint32_t>(key.size()),
+                                 static_cast<std::uint32_t>(row.size()) };
+
+      out.write(reinterpret_cast<const char *>(sizes), sizeof(sizes));
+      out.write(key.data(), key.size());
+      out.write(row.data(), row.size());
+  }
+
+  // sequential reader of one run file
+  class Run
+  {
+
+  public:
+      Run(const std::string &path, std::size_t bufferSize) : _buffer(bufferSize)
+      {
+          open(_stream, _buffer, path, std::ios::in);
+      }
+
+      // read the next record, false at the end of the run
+      bool next(void)
+      {
+          std::uint32_t sizes[2];
+
+          if (!_stream.read(reinterpret_cast<char *>(sizes), sizeof(sizes)))
+              return false;
+          _key.resize(sizes[0]);
+          _row.resize(sizes[1]);
+          if (!_stream.read(&_key[0], sizes[0]) || !_stream.read(&_row[0], sizes[1]))
+              throw Error("Truncated run file");
+          return true;
+      }
+
+      std::string_view key(void) const
+      {
+          return _key;
+      }
+
+      std::string_view row(void) const
+      {
+          return _row;
+      }
+
+  private:
+      std::vector<char> _buffer;
+      std::ifstream _stream;
+      std::string _key;
+      std::string _row;
+  };
+
+  /*
+  ** Tournament tree over k runs. _tree[0] holds the run with the
+  ** smallest current key, _tree[1 .. k-1] the loser of the match
+  ** played at each internal node, leaf i being node k + i. Popping
+  ** the winner only replays the matches on its leaf's path to the
+  ** root, one comparison per level. Ties go to the earlier run, which
+  ** holds the earlier rows, so the merge is stable.
+  */
+  class LoserTree
+  {
+
+  public:
+      LoserTree(std::vector<std::unique_ptr<Run>> &runs)
+        : _runs(runs), _tree(runs.size()), _done(runs.size())
+      {
+          for (std::size_t i = 0; i < _runs.size(); i++)
+              _done[i] = !_runs[i]->next();
+          _tree[0] = build(1);
+      }
+
+      bool empty(void) const
+      {
+          return _done[_tree[0]];
+      }
+
+      const Run &top(void) const
+      {
+          return *_runs[_tree[0]];
+      }
+
+      void pop(void)
+      {
+          std::size_t winner = _tree[0];
+
+          _done[winner] = !_runs[winner]->next();
+          for (std::size_t node = (winner + _runs.size()) / 2; node > 0; node /= 2)
+              if (less(_tree[node], winner))
+                  std::swap(_tree[node], winner);
+          _tree[0] = winner;
+      }
+
+  private:
+      bool less(std::size_t a, std::size_t b) const
+      {
+          if (_done[a] || _done[b])
+              return !_done[a] && _done[b];
+
+          int order = _runs[a]->key().compare(_runs[b]->key());
+          return order != 0 ? order < 0 : a < b;
+      }
+
+      // play the matches below node, return the winner
+      std::size_t build(std::size_t node)
+      {
+          if (node >= _runs.size())
+              return node - _runs.size();
+
+          std::size_t winner = build(2 * node);
+          std::size_t loser = build(2 * node + 1);
+          if (less(loser, winner))
+              std::swap(winner, loser);
+          _tree[node] = loser;
+          return winner;
+      }
+
+  private:
+      std::vector<std::unique_ptr<Run>> &_runs;
+      std::vector<std::size_t> _tree;
+      std::vector<bool> _done;
+  };
+
+  // merge run files, handing every row in order to write(key, row)
+  template <typename Write>
+  static void merge(const std::vector<std::string> &paths, std::size_t bufferSize, Write write)
+  {
+      std::vector<std::unique_ptr<Run>> runs;
+
+      for (auto &path : paths)
+          runs.emplace_back(new Run(path, bufferSize));
+      for (LoserTree tree(runs); !tree.empty(); tree.pop())
+          write(tree.top().key(), tree.top().row());
+  }
+
+  /*
+  ** SORT
+  */
+
+  // rows of the run being built, keys and rows back to back in text
+  struct Entry
+  {
+      std::size_t offset;
+      std::uint32_t keySize;
+      std::uint32_t rowSize;
+  };
+
+  struct RunBuffer
+  {
+      std::string text;
+      std::vector<Entry> entries;
+
+      std::size_t bytes(void) const
+      {
+          return text.size() + entries.size() * sizeof(Entry);
+      }
+
+      std::string_view key(const Entry &entry) const
+      {
+          return std::string_view(text.data() + entry.offset, entry.keySize);
+      }
+
+      std::string_view row(const Entry &entry) const
+      {
+          return std::string_view(text.data() + entry.offset + entry.keySize, entry.rowSize);
+      }
+
+      void add(std::string_view key, std::string_view row)
+      {
+          entries.push_back(Entry{ text.size(), static_cast<std::uint32_t>(key.size()),
+                                   static_cast<std::uint32_t>(row.size()) });
+          text.append(key.data(), key.size());
+          text.append(row.data(), row.size());
+      }
+
+      void sort(void)
+      {
+          std::stable_sort(entries.begin(), entries.end(),
+                           [this](const Entry &a, const Entry &b) { return key(a) < key(b); });
+      }
+
+      void clear(void)
+      {
+          text.clear();
+          entries.clear();
+      }
+  };
+
+  // sort the buffer and write it to a new run file
+  static std::string spill(RunBuffer &buffer, TempFiles &temp, std::vector<char> &streamBuffer)
+  {
+      std::string path = temp.create();
+      std::ofstream out;
+
+      buffer.sort();
+      open(out, streamBuffer, path, std::ios::out | std::ios::trunc);
+      for (auto &entry : buffer.entries)
+          writeRecord(out, buffer.key(entry), buffer.row(entry));
+      out.close();
+      if (!out)
+          throw Error(std::string("Failed to write ").append(path));
+      buffer.clear();
+      return path;
+  }
+
+  Stats sortFile(const std::string &input, const std::string &output,
+                 const std::string &keyColumn, const Options &options)
+  {
+      Stats stats = { 0, 0, 0 };
+      std::size_t budget = std::max(options.memoryBudget, MIN_BUDGET);
+
+      csv::MappedFile file(input);
+      csv::Cursor rows(file, options.sep);
+      if (!rows.next())
+          throw Error(std::string("No header in ").append(input));
+
+      unsigned int key;
+      if (!csv::findColumn(rows, keyColumn, key))
+          throw Error(std::string("no column ").append(keyColumn));
+
+      // the output keeps the header and the line breaks of the input
+      std::string header(record(rows));
+      const char *lineEnd = rows.position();
+      std::string newline = (lineEnd - file.data() >= 2 && lineEnd[-1] == '\n' && lineEnd[-2] == '\r')
+                            ? "\r\n" : "\n";
+
+      TempFiles temp(options.tempDir);
+      std::vector<std::string> runs;
+      std::vector<char> streamBuffer(std::max(budget / 16, MIN_BUFFER));
+      RunBuffer buffer;
+      buffer.text.reserve(std::min(budget, file.size()));
+
+      std::string fieldKey;
+      while (rows.next())
+      {
+          std::string_view row = record(rows);
+          makeKey(key < rows.size() ? rows[key] : std::string_view(), options.keyType, fieldKey);
+
+          std::size_t bytes = fieldKey.size() + row.size() + sizeof(Entry);
+          if (!buffer.entries.empty() && buffer.bytes() + bytes > budget)
+              runs.push_back(spill(buffer, temp, streamBuffer));
+          buffer.add(fieldKey, row);
+          stats.rows++;
+      }
+
+      if (!runs.empty() && !buffer.entries.empty())
+          runs.push_back(spill(buffer, temp, streamBuffer));
+
+      std::ofstream out;
+      open(out, streamBuffer, output, std::ios::out | std::ios::trunc);
+      out << header << newline;
+
+      if (runs.empty())
+      {
+          // everything fit in memory
+          buffer.sort();
+          for (auto &entry : buffer.entries)
+              out << buffer.row(entry) << newline;
+      }
+      else
+      {
+          stats.runs = runs.size();
+          buffer = RunBuffer();
+
+          // merge consecutive groups so earlier rows stay in earlier runs
+          while (runs.size() > MAX_FAN_IN)
+          {
+              std::vector<std::string> merged;
+              for (std::size_t first = 0; first < runs.size(); first += MAX_FAN_IN)
+              {
+                  std::vector<std::string> group(runs.begin() + first,
+                                                 runs.begin() + std::min(first + MAX_FAN_IN, runs.size()));
+                  std::string path = temp.create();
+                  std::vector<char> runBuffer(MIN_BUFFER);
+                  std::ofstream run;
+
+                  open(run, runBuffer, path, std::ios::out | std::ios::trunc);
+                  merge(group, std::max(budget / (group.size() + 1), MIN_BUFFER),
+                        [&run](std::string_view key, std::string_view row) { writeRecord(run, key, row); });
+                  run.close();
+                  if (!run)
+                      throw Error(std::string("Failed to write ").append(path));
+                  for (auto &done : group)
+                      temp.remove(done);
+                  merged.push_back(path);
+              }
+              runs.swap(merged);
+              stats.mergePasses++;
+          }
+
+          merge(runs, std::max(budget / (runs.size() + 1), MIN_BUFFER),
+                [&out, &newline](std::string_view, std::string_view row) { out << row << newline; });
+      }
+
+      out.close();
+      if (!out)
+          throw Error(std::string("Failed to write ").append(output));
+      return stats;
+  }
+}
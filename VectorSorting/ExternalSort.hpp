@@ -0,0 +1,73 @@
+#ifndef     _EXTERNALSORT_HPP_
+# define    _EXTERNALSORT_HPP_
+
+# include <cstddef>
+# include <stdexcept>
+# include <string>
+
+/*
+** External merge sort of a CSV file on one column, for exports larger
+** than the memory the sort may use.
+**
+**   runs       rows are copied into a buffer of at most memoryBudget
+**              bytes, stable sorted on their key and spilled to a run
+**              file in tempDir, until the input is exhausted
+**   merge      the runs are merged through a loser tree (k - 1 losers
+**              over k runs, log k comparisons per row) into the sorted
+**              CSV, header first; more than MAX_FAN_IN runs are first
+**              merged in groups into fewer, longer runs
+**
+** Keys are normalized once when a row is read so the sort and the
+** merge only compare bytes. Rows with equal keys keep their input
+** order. When every row fits in one run nothing is spilled. The input
+** is memory mapped and read once front to back; its pages are cached
+** by the system and don't count against the budget.
+*/
+namespace external
+{
+    class Error : public std::runtime_error
+    {
+
+      public:
+        Error(const std::string &msg):
+          std::runtime_error(std::string("ExternalSort : ").append(msg))
+        {
+        }
+    };
+
+    // how the key column is compared
+    enum KeyType {
+        eTEXT = 0,      // unquoted bytes
+        eNUMBER = 1,    // amount, as csv::toCents reads it
+        eDATE = 2       // m/d/yyyy, as csv::toDate reads it
+    };
+
+    struct Options
+    {
+        std::size_t memoryBudget;   // bytes of rows held in memory at once,
+                                    // at least 1 MiB
+        std::string tempDir;        // where runs are spilled, empty for the
+                                    // system temporary directory
+        KeyType keyType;            // rows whose key doesn't parse come first
+        char sep;
+
+        Options(void);
+    };
+
+    struct Stats
+    {
+        std::size_t rows;
+        std::size_t runs;           // runs spilled, 0 when sorted in memory
+        std::size_t mergePasses;    // merges of intermediate runs
+    };
+
+    /*
+    ** The key column is given by header name (surrounding blanks and
+    ** case ignored) or by 0 based index. The output is written as a
+    ** whole: it should not be the input file.
+    */
+    Stats sortFile(const std::string &input, const std::string &output,
+                   const std::string &keyColumn, const Options &options = Options());
+}
+
+#endif /*!_EXTERNALSORT_HPP_*/
@@ -1,343 +1,1584 @@
-//============================================================================
-// Name        : VectorSorting.cpp
-// Author      : Your name
-// Version     : 1.0
-// Copyright   : Copyright  2023 SNHU COCE
-// Description : Vector Sorting Algorithms
-//============================================================================
-
-#include <algorithm>
-#include <iostream>
-#include <time.h>
-
-#include "CSVparser.hpp"
-
-using namespace std;
-
-//============================================================================
-// Global definitions visible to all methods and classes
-//============================================================================
-
-// forward declarations
-double strToDouble(string str, char ch);
-
-// define a structure to hold bid information
-struct Bid {
-    string bidId; // unique identifier
-    string title;
-    string fund;
-    double amount;
-    Bid() {
-        amount = 0.0;
-    }
-};
-
-//============================================================================
-// Static methods used for testing
-//============================================================================
-
-/**
- * Display the bid information to the console (std::out)
- *
- * @param bid struct containing the bid info
- */
-void displayBid(Bid bid) {
-    cout << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
-            << bid.fund << endl;
-    return;
-}
-
-/**
- * Prompt user for bid information using console (std::in)
- *
- * @return Bid struct containing the bid info
- */
-Bid getBid() {
-    Bid bid;
-
-    cout << "Enter Id: ";
-    cin.ignore();
-    getline(cin, bid.bidId);
-
-    cout << "Enter title: ";
-    getline(cin, bid.title);
-
-    cout << "Enter fund: ";
-    cin >> bid.fund;
-
-    cout << "Enter amount: ";
-    cin.ignore();
-    string strAmount;
-    getline(cin, strAmount);
-    bid.amount = strToDouble(strAmount, '$');
-
-    return bid;
-}
-
-/**
- * Load a CSV file containing bids into a container
- *
- * @param csvPath the path to the CSV file to load
- * @return a container holding all the bids read
- */
-vector<Bid> loadBids(string csvPath) {
-    cout << "Loading CSV file " << csvPath << endl;
-
-    // Define a vector data structure to hold a collection of bids.
-    vector<Bid> bids;
-
-    // initialize the CSV Parser using the given path
-    csv::Parser file = csv::Parser(csvPath);
-
-    try {
-        // loop to read rows of a CSV file
-        for (int i = 0; i < file.rowCount(); i++) {
-
-            // Create a data structure and add to the collection of bids
-            Bid bid;
-            bid.bidId = file[i][1];
-            bid.title = file[i][0];
-            bid.fund = file[i][8];
-            bid.amount = strToDouble(file[i][4], '$');
-
-            //cout << "Item: " << bid.title << ", Fund: " << bid.fund << ", Amount: " << bid.amount << endl;
-
-            // push this bid to the end
-            bids.push_back(bid);
-        }
-    } catch (csv::Error &e) {
-        std::cerr << e.what() << std::endl;
-    }
-    return bids;
-}
-
-// FIXME (2a): Implement the quick sort logic over bid.title
-
-/**
- * Partition the vector of bids into two parts, low and high
- *
- * @param bids Address of the vector<Bid> instance to be partitioned
- * @param begin Beginning index to partition
- * @param end Ending index to partition
- */
-int partition(vector<Bid>& bids, int begin, int end) {
-    //set low and high equal to begin and end
-
-    int l = begin;
-    int h = end;
-
-    int pivot = (begin + (end - begin) / 2);
-    bool finished = false;
-    // Calculate the middle element as middlePoint (int)
-    // Set Pivot as middlePoint element title to compare (string)  
-
-    // while not done 
-    while (!finished) {
-        while (bids[l].title.compare(bids[pivot].title) < 0) {
-            ++l;
-        }
-        while (bids[pivot].title.compare(bids[h].title) < 0) {
-            --h;
-        }
-        if (l >= h) {
-            finished = true;
-        }
-        else {
-            swap(bids[l], bids[h]);
-            ++l;
-            --h;
-        }
-    }
-    return h;
-
-
-        // keep incrementing low index while bids[low].title < Pivot
-       
-        // keep decrementing high index while Pivot < bids[high].title
-
-        /* If there are zero or one elements remaining,
-            all bids are partitioned. Return high */
-       // else swap the low and high bids (built in vector method)
-            // move low and high closer ++low, --high
-    //return high;
-}
-
-/**
- * Perform a quick sort on bid title
- * Average performance: O(n log(n))
- * Worst case performance O(n^2))
- *
- * @param bids address of the vector<Bid> instance to be sorted
- * @param begin the beginning index to sort on
- * @param end the ending index to sort on
- */
-void quickSort(vector<Bid>& bids, int begin, int end) {
-    unsigned int middle = 0;
-
-    if (begin >= end) {
-        return;
-    }
-
-    middle = partition(bids, begin, end);
-    //set mid equal to 0
-    quickSort(bids, begin, middle);
-
-    quickSort(bids, middle + 1, end);
-    /* Base case: If there are 1 or zero bids to sort,
-     partition is already sorted otherwise if begin is greater
-     than or equal to end then return*/
-
-    /* Partition bids into low and high such that
-     midpoint is location of last element in low */
-     
-    // recursively sort low partition (begin to mid)
-
-    // recursively sort high partition (mid+1 to end)
-
-}
-
-// FIXME (1a): Implement the selection sort logic over bid.title
-
-/**
- * Perform a selection sort on bid title
- * Average performance: O(n^2))
- * Worst case performance O(n^2))
- *
- * @param bid address of the vector<Bid>
- *            instance to be sorted
- */
-void selectionSort(vector<Bid>& bids) {
-    //define min as int (index of the current minimum bid)
-    unsigned int smallest;
-    unsigned int largest = bids.size();
-    // check size of bids vector
-    // set size_t platform-neutral result equal to bid.size()
-    for (unsigned place = 0; place < largest; ++place) {
-        smallest = place;
-
-        for (unsigned j = place + 1; j < largest; ++j) {
-            if (bids[j].title.compare(bids[smallest].title) < 0) {
-                smallest = j;
-            }
-        }
-        if (smallest != place) {
-            swap(bids[place], bids[smallest]);
-        }
-
-    }
-    // pos is the position within bids that divides sorted/unsorted
-    // for size_t pos = 0 and less than size -1 
-        // set min = pos
-        // loop over remaining elements to the right of position
-            // if this element's title is less than minimum title
-                // this element becomes the minimum
-        // swap the current minimum with smaller one found
-            // swap is a built in vector method
-}
-
-/**
- * Simple C function to convert a string to a double
- * after stripping out unwanted char
- *
- * credit: http://stackoverflow.com/a/24875936
- *
- * @param ch The character to strip out
- */
-double strToDouble(string str, char ch) {
-    str.erase(remove(str.begin(), str.end(), ch), str.end());
-    return atof(str.c_str());
-}
-
-/**
- * The one and only main() method
- */
-int main(int argc, char* argv[]) {
-
-    // process command line arguments
-    string csvPath;
-    switch (argc) {
-    case 2:
-        csvPath = argv[1];
-        break;
-    default:
-        csvPath = "eBid_Monthly_Sales.csv";
-    }
-
-    // Define a vector to hold all the bids
-    vector<Bid> bids;
-
-    // Define a timer variable
-    clock_t ticks;
-
-    int choice = 0;
-    while (choice != 9) {
-        cout << "Menu:" << endl;
-        cout << "  1. Load Bids" << endl;
-        cout << "  2. Display All Bids" << endl;
-        cout << "  3. Selection Sort All Bids" << endl;
-        cout << "  4. Quick Sort All Bids" << endl;
-        cout << "  9. Exit" << endl;
-        cout << "Enter choice: ";
-        cin >> choice;
-
-        switch (choice) {
-
-        case 1:
-            // Initialize a timer variable before loading bids
-            ticks = clock();
-
-            // Complete the method call to load the bids
-            bids = loadBids(csvPath);
-
-            cout << bids.size() << " bids read" << endl;
-
-            // Calculate elapsed time and display result
-            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
-            cout << "time: " << ticks << " clock ticks" << endl;
-            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
-
-            break;
-
-        case 2:
-            // Loop and display the bids read
-            for (int i = 0; i < bids.size(); ++i) {
-                displayBid(bids[i]);
-            }
-            cout << endl;
-
-            break;
-
-        // FIXME (1b): Invoke the selection sort and report timing results
-        case 3:
-            ticks = clock();
-
-            selectionSort(bids);
-
-            cout << bids.size() << " bids read" << endl;
-
-            ticks = clock() - ticks;
-            cout << "time: " << ticks << " clock ticks" << endl;
-            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
-
-            break;
-
-        // FIXME (2b): Invoke the quick sort and report timing results
-        case 4:
-            ticks = clock();
-
-            quickSort(bids, 0, bids.size() - 1);
-
-            cout << bids.size() << " bids read" << endl;
-
-            ticks = clock() - ticks;
-            cout << "time: " << ticks << " clock ticks" << endl;
-            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
-
-            break;
-        }
-    }
-
-    cout << "Good bye." << endl;
-
-    return 0;
-}
+//============================================================================
+// Name        : VectorSorting.cpp
+// Author      : Your name
+// Version     : 1.0
+// Copyright   : Copyright  2023 SNHU COCE
+// Description : Vector Sorting Algorithms
+//============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <thread>
+#include <time.h>
+
+#include "BidReport.hpp"
+#include "BidSnapshot.hpp"
+#include "BidTable.hpp"
+#include "CSVparser.hpp"
+#include "ExternalSort.hpp"
+
+using namespace std;
+
+//============================================================================
+// Global definitions visible to all methods and classes
+//============================================================================
+
+// define a structure to hold bid information
+struct Bid {
+    string bidId; // unique identifier
+    string title;
+    csv::Symbol fund; // interned, only a few distinct funds
+    long long amount; // winning bid in cents
+    csv::Date closeDate; // all 0 when unknown
+    unsigned long long idNumber; // bidId as a number, see idNumberOf
+    Bid() {
+        amount = 0;
+        closeDate = csv::Date();
+        idNumber = ULLONG_MAX;
+    }
+};
+
+/**
+ * Parse a bid id once so sorting by id compares numbers
+ *
+ * @param bidId the bid id
+ * @return the id as a number, ULLONG_MAX when it is not one
+ */
+unsigned long long idNumberOf(const string& bidId) {
+    long long value;
+    if (csv::toInteger(bidId, value) && value >= 0) {
+        return value;
+    }
+    return ULLONG_MAX;
+}
+
+//============================================================================
+// Static methods used for testing
+//============================================================================
+
+/**
+ * Display the bid information to the console (std::out)
+ *
+ * @param bid struct containing the bid info
+ */
+void displayBid(Bid bid) {
+    cout << bid.bidId << ": " << bid.title << " | " << bid.amount / 100.0 << " | "
+            << bid.fund;
+    if (bid.closeDate.year != 0) {
+        cout << " | " << bid.closeDate.month << "/" << bid.closeDate.day << "/" << bid.closeDate.year;
+    }
+    cout << endl;
+    return;
+}
+
+/**
+ * Prompt user for bid information using console (std::in)
+ *
+ * @return Bid struct containing the bid info
+ */
+Bid getBid() {
+    Bid bid;
+
+    cout << "Enter Id: ";
+    cin.ignore();
+    getline(cin, bid.bidId);
+    bid.idNumber = idNumberOf(bid.bidId);
+
+    cout << "Enter title: ";
+    getline(cin, bid.title);
+
+    cout << "Enter fund: ";
+    cin >> bid.fund;
+
+    cout << "Enter amount: ";
+    cin.ignore();
+    string strAmount;
+    while (getline(cin, strAmount) && !csv::toCents(strAmount, bid.amount)) {
+        cout << "Enter amount in dollars: ";
+    }
+
+    return bid;
+}
+
+// CSV columns a bid is built from: title, id, close date, winning bid
+// and fund
+const csv::Columns BID_COLUMNS = { 0, 1, 3, 4, 8 };
+
+/**
+ * Build a bid from the current row of a CSV cursor
+ * projected on BID_COLUMNS
+ *
+ * @param row cursor positioned on a data row
+ * @return Bid struct containing the bid info, empty when the
+ *         winning bid can't be read
+ */
+optional<Bid> parseBid(const csv::Cursor& row) {
+    Bid bid;
+    bid.bidId = row.unquote(1);
+    bid.idNumber = idNumberOf(bid.bidId);
+    bid.title = row.unquote(0);
+    bid.fund = row.unquote(4);
+    if (!csv::toCents(row[3], bid.amount)) {
+        return nullopt;
+    }
+    if (!csv::toDate(row[2], bid.closeDate) || bid.closeDate.year < 1 || bid.closeDate.year > 9999) {
+        bid.closeDate = csv::Date();
+    }
+    return bid;
+}
+
+/**
+ * Parse the bids of a mapped CSV file on all cores, they come
+ * back in file order. Rows whose winning bid can't be read are
+ * skipped and counted.
+ *
+ * @param file the mapped CSV file
+ * @return the bids read
+ */
+vector<Bid> parseBids(const csv::MappedFile& file) {
+    vector<optional<Bid>> rows = csv::parallelLoad<optional<Bid>>(file, parseBid, BID_COLUMNS);
+
+    vector<Bid> bids;
+    bids.reserve(rows.size());
+    for (auto& row : rows) {
+        if (row) {
+            bids.push_back(move(*row));
+        }
+    }
+    if (bids.size() != rows.size()) {
+        cout << rows.size() - bids.size() << " rows skipped, their winning bid can't be read" << endl;
+    }
+    return bids;
+}
+
+/**
+ * Load bids from the binary snapshot of a CSV file
+ *
+ * @param csvPath the path to the CSV file the snapshot was made from
+ * @param bids vector receiving the bids
+ * @return true when an up to date snapshot with close dates
+ *         was found
+ */
+bool loadSnapshot(string csvPath, vector<Bid>& bids) {
+    try {
+        snapshot::Reader snap(snapshot::pathFor(csvPath));
+        if (!snap.fresh(csvPath) || !snap.hasDates()) {
+            return false;
+        }
+
+        bids.reserve(snap.size());
+        for (unsigned int i = 0; i < snap.size(); ++i) {
+            Bid bid;
+            bid.bidId = snap.bidId(i);
+            bid.idNumber = idNumberOf(bid.bidId);
+            bid.title = snap.title(i);
+            bid.fund = snap.fund(i);
+            bid.amount = snap.amount(i);
+            bid.closeDate = snap.closeDate(i);
+            bids.push_back(bid);
+        }
+    } catch (snapshot::Error &e) {
+        bids.clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Save bids read from a CSV file to its binary snapshot
+ *
+ * @param csvPath the path to the CSV file the bids were read from
+ * @param bids the bids to save
+ */
+void saveSnapshot(string csvPath, const vector<Bid>& bids) {
+    snapshot::Writer writer;
+    try {
+        for (auto const& bid : bids) {
+            writer.add(bid.bidId, bid.title, bid.fund.str(), bid.amount, bid.closeDate);
+        }
+        writer.write(snapshot::pathFor(csvPath), csvPath);
+    } catch (snapshot::Error &e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+/**
+ * Load a CSV file containing bids into a container
+ *
+ * @param csvPath the path to the CSV file to load
+ * @return a container holding all the bids read
+ */
+vector<Bid> loadBids(string csvPath) {
+    cout << "Loading CSV file " << csvPath << endl;
+
+    // Define a vector data structure to hold a collection of bids.
+    vector<Bid> bids;
+
+    // reuse the binary snapshot while it matches the CSV file
+    if (loadSnapshot(csvPath, bids)) {
+        return bids;
+    }
+
+    try {
+        // map the CSV file and parse the rows on all cores,
+        // they come back in file order
+        csv::MappedFile file(csvPath);
+        bids = parseBids(file);
+        saveSnapshot(csvPath, bids);
+    } catch (csv::Error &e) {
+        std::cerr << e.what() << std::endl;
+    }
+    return bids;
+}
+
+/**
+ * Copy bids into a column store for scans
+ *
+ * @param bids the bids to copy
+ * @return a BidTable holding the same bids, in the same order
+ */
+BidTable toBidTable(const vector<Bid>& bids) {
+    size_t textBytes = 0;
+    for (auto const& bid : bids) {
+        textBytes += bid.bidId.size() + bid.title.size();
+    }
+
+    BidTable table;
+    table.reserve(bids.size(), textBytes);
+    for (auto const& bid : bids) {
+        table.append(bid.bidId, bid.title, bid.fund, bid.amount);
+    }
+    return table;
+}
+
+/**
+ * Format an amount in cents as dollars with two decimals
+ */
+string dollars(long long cents) {
+    string text = cents < 0 ? "-" : "";
+    unsigned long long magnitude = cents < 0 ? 0 - static_cast<unsigned long long>(cents) : cents;
+    string fraction = to_string(magnitude % 100);
+    return text + to_string(magnitude / 100) + (fraction.size() < 2 ? ".0" : ".") + fraction;
+}
+
+/**
+ * Prompt for an amount range and a fund, then report the count,
+ * total, smallest and largest winning bid matching them. The same
+ * filter is timed on the column store and on the vector of bids,
+ * averaged over SCAN_ROUNDS runs.
+ *
+ * @param bids the loaded bids
+ * @param table the same bids as a BidTable
+ */
+void reportAmounts(const vector<Bid>& bids, const BidTable& table) {
+    string low, high, fundName;
+
+    BidTable::Filter filter;
+    cout << "Enter smallest and largest amount (or * for no limit): ";
+    cin >> low >> high;
+    if (low != "*" && !csv::toCents(low, filter.minAmount)) {
+        cout << "Invalid amount " << low << endl;
+        return;
+    }
+    if (high != "*" && !csv::toCents(high, filter.maxAmount)) {
+        cout << "Invalid amount " << high << endl;
+        return;
+    }
+
+    cout << "Enter fund (or * for all funds): ";
+    cin.ignore();
+    getline(cin, fundName);
+    csv::Symbol fund(fundName);
+    if (fundName != "*") {
+        filter.fundCode = table.fundCode(fund);
+    }
+
+    const int SCAN_ROUNDS = 100;
+
+    BidTable::Stats stats;
+    auto start = chrono::steady_clock::now();
+    for (int round = 0; round < SCAN_ROUNDS; ++round) {
+        stats = table.scan(filter);
+    }
+    chrono::duration<double, micro> columnar = chrono::steady_clock::now() - start;
+
+    // the same filter over the array of structs, for comparison
+    size_t count = 0;
+    long long sum = 0;
+    start = chrono::steady_clock::now();
+    for (int round = 0; round < SCAN_ROUNDS; ++round) {
+        count = 0;
+        sum = 0;
+        for (auto const& bid : bids) {
+            bool keep = bid.amount >= filter.minAmount && bid.amount <= filter.maxAmount
+                        && (filter.fundCode == BidTable::ANY_FUND || bid.fund == fund);
+            count += keep;
+            sum += keep ? bid.amount : 0;
+        }
+    }
+    chrono::duration<double, micro> rows = chrono::steady_clock::now() - start;
+
+    cout << stats.count << " bids, total " << dollars(stats.sum);
+    if (stats.count > 0) {
+        cout << ", smallest " << dollars(stats.min) << ", largest " << dollars(stats.max);
+    }
+    cout << endl;
+    if (count != stats.count || sum != stats.sum) {
+        cout << "(vector scan disagrees: " << count << " bids, total " << dollars(sum) << ")" << endl;
+    }
+    cout << "time: " << columnar.count() / SCAN_ROUNDS << " us columnar, "
+         << rows.count() / SCAN_ROUNDS << " us vector of bids" << endl;
+}
+
+/**
+ * Group the rows of a CSV file by one column and print the count,
+ * total, average, smallest and largest amount of another column
+ * for every group
+ *
+ * @param csvPath the path to the CSV file to read
+ * @param keyColumn name or 0 based index of the column to group by
+ * @param valueColumn column holding the amounts, empty to only count
+ * @return false when the file can't be read or a column isn't found
+ */
+bool groupBids(string csvPath, string keyColumn, string valueColumn) {
+    vector<report::Group> groups;
+
+    auto start = chrono::steady_clock::now();
+    try {
+        csv::MappedFile file(csvPath);
+        groups = report::groupBy(file, keyColumn, valueColumn);
+    } catch (csv::Error &e) {
+        std::cerr << e.what() << std::endl;
+        return false;
+    } catch (report::Error &e) {
+        std::cerr << e.what() << std::endl;
+        return false;
+    }
+    chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+
+    for (auto const& group : groups) {
+        cout << (group.key.empty() ? "(blank)" : group.key) << " | " << group.values.rows << " bids";
+        if (group.values.count > 0) {
+            cout << " | total " << dollars(group.values.sum)
+                 << " | average " << dollars(llround(group.values.average()))
+                 << " | smallest " << dollars(group.values.min)
+                 << " | largest " << dollars(group.values.max);
+        }
+        cout << endl;
+    }
+    cout << groups.size() << " groups" << endl;
+    cout << "time: " << elapsed.count() << " milliseconds" << endl;
+    return true;
+}
+
+/**
+ * Sort the rows of a CSV file on one column into another CSV file,
+ * with at most a memory budget of rows in memory, and report the
+ * number of rows, runs spilled and time taken
+ *
+ * @param csvPath the path to the CSV file to sort
+ * @param outputPath the path of the sorted CSV file to write
+ * @param keyColumn name or 0 based index of the column to sort on
+ * @param options memory budget, temporary directory and key type
+ * @return false when a file can't be read or written or the column isn't found
+ */
+bool sortBidFile(string csvPath, string outputPath, string keyColumn, const external::Options& options) {
+    external::Stats stats;
+
+    auto start = chrono::steady_clock::now();
+    try {
+        stats = external::sortFile(csvPath, outputPath, keyColumn, options);
+    } catch (csv::Error &e) {
+        std::cerr << e.what() << std::endl;
+        return false;
+    } catch (external::Error &e) {
+        std::cerr << e.what() << std::endl;
+        return false;
+    }
+    chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+
+    cout << stats.rows << " rows sorted into " << outputPath;
+    if (stats.runs == 0) {
+        cout << " in memory" << endl;
+    } else {
+        cout << " through " << stats.runs << " runs and " << stats.mergePasses << " extra merge passes" << endl;
+    }
+    cout << "time: " << elapsed.count() << " milliseconds" << endl;
+    return true;
+}
+
+//============================================================================
+// Sort keys
+//============================================================================
+
+/*
+ * A sort key orders bids through two members:
+ *
+ *   int operator()(a, b)    three-way comparison, negative when bid a
+ *                           sorts before bid b, 0 when they tie
+ *   prefix(bid)             the key packed in an integer, a lower
+ *                           prefix always means an earlier bid
+ *
+ * EXACT is true when equal prefixes also mean a tie, so sorts on the
+ * prefixes never need to look at the bids themselves.
+ */
+
+/**
+ * Pack the first bytes of a text into an integer, big endian and
+ * zero padded, so integer order is text order
+ *
+ * @param text the text to pack
+ * @param bytes how many bytes to keep, at most 8
+ */
+unsigned long long textPrefix(const string& text, size_t bytes) {
+    unsigned long long prefix = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        prefix = prefix << 8 | (i < text.size() ? static_cast<unsigned char>(text[i]) : 0);
+    }
+    return prefix;
+}
+
+/**
+ * Pack a date as yyyymmdd, 0 for an unknown date
+ */
+unsigned int dateKey(const csv::Date& date) {
+    return date.year * 10000 + date.month * 100 + date.day;
+}
+
+// title, alphabetically
+struct ByTitle {
+    static const bool EXACT = false;
+
+    int operator()(const Bid& a, const Bid& b) const {
+        return a.title.compare(b.title);
+    }
+
+    unsigned long long prefix(const Bid& bid) const {
+        return textPrefix(bid.title, 8);
+    }
+};
+
+// bid id as a number, ids that are not numbers come last
+struct ByBidId {
+    static const bool EXACT = false;
+
+    int operator()(const Bid& a, const Bid& b) const {
+        if (a.idNumber != b.idNumber) {
+            return a.idNumber < b.idNumber ? -1 : 1;
+        }
+        return a.bidId.compare(b.bidId);
+    }
+
+    unsigned long long prefix(const Bid& bid) const {
+        return bid.idNumber;
+    }
+};
+
+// close date, oldest first, unknown dates before all others
+struct ByCloseDate {
+    static const bool EXACT = true;
+
+    int operator()(const Bid& a, const Bid& b) const {
+        unsigned int x = dateKey(a.closeDate);
+        unsigned int y = dateKey(b.closeDate);
+        return x < y ? -1 : (x > y ? 1 : 0);
+    }
+
+    unsigned long long prefix(const Bid& bid) const {
+        return dateKey(bid.closeDate);
+    }
+};
+
+// fund alphabetically, then winning bid from highest to lowest
+struct ByFundThenAmount {
+    static const bool EXACT = false;
+
+    int operator()(const Bid& a, const Bid& b) const {
+        if (a.fund != b.fund) {
+            return a.fund < b.fund ? -1 : 1;
+        }
+        return a.amount > b.amount ? -1 : (a.amount < b.amount ? 1 : 0);
+    }
+
+    // 8 bytes of fund only: a cut fund followed by the amount would
+    // put funds sharing their first bytes in amount order
+    unsigned long long prefix(const Bid& bid) const {
+        return textPrefix(bid.fund.str(), 8);
+    }
+};
+
+// winning bid, highest first
+struct ByAmount {
+    static const bool EXACT = false;
+
+    int operator()(const Bid& a, const Bid& b) const {
+        return a.amount > b.amount ? -1 : (a.amount < b.amount ? 1 : 0);
+    }
+
+    // the amount clamped to 63 bits and flipped so higher amounts
+    // come first
+    unsigned long long prefix(const Bid& bid) const {
+        return static_cast<unsigned long long>(LLONG_MAX) - max(bid.amount, 0LL);
+    }
+};
+
+// names of the sort keys, see visitKey
+const vector<string> SORT_KEYS = { "title", "id", "date", "fund", "amount" };
+
+/**
+ * Call a function with the sort key of a given name
+ *
+ * @param keyName one of SORT_KEYS: title, id (numeric), date (close
+ *        date), fund (fund, then highest winning bid first) or
+ *        amount (highest winning bid first)
+ * @param visit generic function taking the key
+ * @return false, without calling visit, for an unknown key
+ */
+template <typename Visit>
+bool visitKey(string keyName, Visit visit) {
+    if (keyName == "title") {
+        visit(ByTitle());
+    } else if (keyName == "id") {
+        visit(ByBidId());
+    } else if (keyName == "date") {
+        visit(ByCloseDate());
+    } else if (keyName == "fund") {
+        visit(ByFundThenAmount());
+    } else if (keyName == "amount") {
+        visit(ByAmount());
+    } else {
+        return false;
+    }
+    return true;
+}
+
+//============================================================================
+// Quick sort (introsort)
+//============================================================================
+
+// ranges this short are finished with an insertion sort
+const int INSERTION_CUTOFF = 16;
+
+// ranges this long take the ninther of nine items as pivot
+const int NINTHER_THRESHOLD = 128;
+
+/**
+ * Perform an insertion sort, quick on the short ranges left over by
+ * quick sort
+ *
+ * @param items address of the vector instance to be sorted
+ * @param begin the beginning index to sort on
+ * @param end the ending index to sort on
+ * @param compare three-way comparison of two items
+ */
+template <typename T, typename Compare>
+void insertionSort(vector<T>& items, int begin, int end, Compare compare) {
+    for (int i = begin + 1; i <= end; ++i) {
+        if (compare(items[i], items[i - 1]) >= 0) {
+            continue;
+        }
+
+        // shift the larger items right and drop the item in the gap
+        T item = move(items[i]);
+        int j = i;
+        for (; j > begin && compare(item, items[j - 1]) < 0; --j) {
+            items[j] = move(items[j - 1]);
+        }
+        items[j] = move(item);
+    }
+}
+
+/**
+ * Perform a heap sort, the fallback that keeps quick sort
+ * O(n log(n)) when its pivots keep going wrong
+ *
+ * @param items address of the vector instance to be sorted
+ * @param begin the beginning index to sort on
+ * @param end the ending index to sort on
+ * @param compare three-way comparison of two items
+ */
+template <typename T, typename Compare>
+void heapSort(vector<T>& items, int begin, int end, Compare compare) {
+    auto less = [&compare](const T& a, const T& b) { return compare(a, b) < 0; };
+    make_heap(items.begin() + begin, items.begin() + end + 1, less);
+    sort_heap(items.begin() + begin, items.begin() + end + 1, less);
+}
+
+/**
+ * Return the index of the median of three items
+ */
+template <typename T, typename Compare>
+int medianOfThree(const vector<T>& items, int a, int b, int c, Compare& compare) {
+    if (compare(items[a], items[b]) < 0) {
+        if (compare(items[b], items[c]) < 0) {
+            return b;
+        }
+        return compare(items[a], items[c]) < 0 ? c : a;
+    }
+    if (compare(items[a], items[c]) < 0) {
+        return a;
+    }
+    return compare(items[b], items[c]) < 0 ? c : b;
+}
+
+/**
+ * Choose the pivot of a range: the median of its first, middle and
+ * last items, or on long ranges the median of three such medians
+ * (Tukey's ninther) so sorted, reversed and organ pipe input still
+ * split near the middle
+ */
+template <typename T, typename Compare>
+int choosePivot(const vector<T>& items, int begin, int end, Compare& compare) {
+    int middle = begin + (end - begin) / 2;
+    if (end - begin + 1 < NINTHER_THRESHOLD) {
+        return medianOfThree(items, begin, middle, end, compare);
+    }
+
+    int step = (end - begin + 1) / 8;
+    return medianOfThree(items,
+            medianOfThree(items, begin, begin + step, begin + 2 * step, compare),
+            medianOfThree(items, middle - step, middle, middle + step, compare),
+            medianOfThree(items, end - 2 * step, end - step, end, compare),
+            compare);
+}
+
+/**
+ * Partition the vector into three parts around a pivot: items
+ * lower than the pivot, items tied with it and items higher than
+ * it. The tied items are in their final place, so runs of
+ * duplicates are never partitioned again.
+ *
+ * @param items Address of the vector instance to be partitioned
+ * @param begin Beginning index to partition
+ * @param end Ending index to partition
+ * @param compare three-way comparison of two items
+ * @param low set to the first index of the items tied with the pivot
+ * @param high set to the last index of the items tied with the pivot
+ */
+template <typename T, typename Compare>
+void partition(vector<T>& items, int begin, int end, Compare& compare, int& low, int& high) {
+    swap(items[begin], items[choosePivot(items, begin, end, compare)]);
+
+    // a copy, the pivot item itself moves while partitioning
+    const T pivot = items[begin];
+
+    // [begin, low) < pivot, [low, i) == pivot, (high, end] > pivot
+    low = begin;
+    high = end;
+    int i = begin + 1;
+    while (i <= high) {
+        int order = compare(items[i], pivot);
+        if (order < 0) {
+            swap(items[low++], items[i++]);
+        } else if (order > 0) {
+            swap(items[i], items[high--]);
+        } else {
+            ++i;
+        }
+    }
+}
+
+/**
+ * Quick sort a range, switching to heap sort once depthLimit
+ * levels of partitioning have not finished it
+ *
+ * @param items address of the vector instance to be sorted
+ * @param begin the beginning index to sort on
+ * @param end the ending index to sort on
+ * @param depthLimit partitioning levels left before heap sort
+ * @param compare three-way comparison of two items
+ */
+template <typename T, typename Compare>
+void introSort(vector<T>& items, int begin, int end, int depthLimit, Compare& compare) {
+    while (end - begin + 1 > INSERTION_CUTOFF) {
+        if (depthLimit == 0) {
+            heapSort(items, begin, end, compare);
+            return;
+        }
+        --depthLimit;
+
+        int low, high;
+        partition(items, begin, end, compare, low, high);
+
+        // recurse into the smaller part and loop on the larger one,
+        // the stack never gets deeper than log(n)
+        if (low - begin < end - high) {
+            introSort(items, begin, low - 1, depthLimit, compare);
+            begin = high + 1;
+        } else {
+            introSort(items, high + 1, end, depthLimit, compare);
+            end = low - 1;
+        }
+    }
+    insertionSort(items, begin, end, compare);
+}
+
+/**
+ * Perform a quick sort
+ * Average performance: O(n log(n))
+ * Worst case performance O(n log(n)), past 2 log(n) levels of
+ * bad pivots the rest of a range is heap sorted
+ *
+ * @param items address of the vector instance to be sorted
+ * @param begin the beginning index to sort on
+ * @param end the ending index to sort on
+ * @param compare three-way comparison of two items, such as a
+ *        sort key
+ */
+template <typename T, typename Compare>
+void quickSort(vector<T>& items, int begin, int end, Compare compare) {
+    if (begin >= end) {
+        return;
+    }
+    introSort(items, begin, end, 2 * static_cast<int>(log2(end - begin + 1)), compare);
+}
+
+/**
+ * Perform a quick sort on bid title
+ *
+ * @param bids address of the vector<Bid> instance to be sorted
+ * @param begin the beginning index to sort on
+ * @param end the ending index to sort on
+ */
+void quickSort(vector<Bid>& bids, int begin, int end) {
+    quickSort(bids, begin, end, ByTitle());
+}
+
+// FIXME (1a): Implement the selection sort logic over bid.title
+
+/**
+ * Perform a selection sort
+ * Average performance: O(n^2))
+ * Worst case performance O(n^2))
+ *
+ * @param items address of the vector
+ *            instance to be sorted
+ * @param compare three-way comparison of two items
+ */
+template <typename T, typename Compare>
+void selectionSort(vector<T>& items, Compare compare) {
+    //define min as int (index of the current minimum bid)
+    unsigned int smallest;
+    unsigned int largest = items.size();
+    // check size of bids vector
+    // set size_t platform-neutral result equal to bid.size()
+    for (unsigned place = 0; place < largest; ++place) {
+        smallest = place;
+
+        for (unsigned j = place + 1; j < largest; ++j) {
+            if (compare(items[j], items[smallest]) < 0) {
+                smallest = j;
+            }
+        }
+        if (smallest != place) {
+            swap(items[place], items[smallest]);
+        }
+
+    }
+    // pos is the position within bids that divides sorted/unsorted
+    // for size_t pos = 0 and less than size -1 
+        // set min = pos
+        // loop over remaining elements to the right of position
+            // if this element's title is less than minimum title
+                // this element becomes the minimum
+        // swap the current minimum with smaller one found
+            // swap is a built in vector method
+}
+
+/**
+ * Perform a selection sort on bid title
+ *
+ * @param bid address of the vector<Bid>
+ *            instance to be sorted
+ */
+void selectionSort(vector<Bid>& bids) {
+    selectionSort(bids, ByTitle());
+}
+
+//============================================================================
+// Index sort
+//============================================================================
+
+// sort entry of a bid: its key prefix and its index in the vector
+struct SortEntry {
+    unsigned long long prefix;
+    unsigned int index;
+};
+
+/**
+ * Sort bids on a key without moving them. Only an array of 16 byte
+ * entries is sorted: the key prefixes are computed once, most
+ * comparisons are settled by them, the bids are only read when two
+ * prefixes are equal and the key is not EXACT, and tied bids keep
+ * their original order.
+ *
+ * @param bids the bids to sort, left untouched
+ * @param key the sort key
+ * @return the sorted order, bids[order[0]] sorts first
+ */
+template <typename Key>
+vector<unsigned int> keyOrder(const vector<Bid>& bids, const Key& key) {
+    vector<SortEntry> entries(bids.size());
+    for (size_t i = 0; i < bids.size(); ++i) {
+        entries[i].prefix = key.prefix(bids[i]);
+        entries[i].index = i;
+    }
+
+    quickSort(entries, 0, entries.size() - 1, [&bids, &key](const SortEntry& a, const SortEntry& b) {
+        if (a.prefix != b.prefix) {
+            return a.prefix < b.prefix ? -1 : 1;
+        }
+        int order = Key::EXACT ? 0 : key(bids[a.index], bids[b.index]);
+        if (order != 0) {
+            return order;
+        }
+        return a.index < b.index ? -1 : (a.index > b.index ? 1 : 0);
+    });
+
+    vector<unsigned int> order(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        order[i] = entries[i].index;
+    }
+    return order;
+}
+
+/**
+ * Rearrange bids in a given order, moving every bid once
+ *
+ * @param bids the bids to rearrange
+ * @param order a permutation of the indexes of bids, as returned
+ *        by keyOrder
+ */
+void applyOrder(vector<Bid>& bids, const vector<unsigned int>& order) {
+    vector<Bid> ordered;
+    ordered.reserve(bids.size());
+    for (auto index : order) {
+        ordered.push_back(move(bids[index]));
+    }
+    bids.swap(ordered);
+}
+
+//============================================================================
+// MSD radix sort over bid.title
+//============================================================================
+
+// ranges this short are finished with an insertion sort
+const size_t RADIX_CUTOFF = 32;
+
+// a title under radix sort, pointing into the bid that holds it
+struct TitleRef {
+    const char* text;
+    unsigned int size;
+    unsigned int index;
+};
+
+/**
+ * Return the bucket of a title at a depth: 0 once past its end,
+ * the byte plus one otherwise
+ */
+inline unsigned int radixBucket(const TitleRef& ref, size_t depth) {
+    return depth < ref.size ? static_cast<unsigned char>(ref.text[depth]) + 1 : 0;
+}
+
+/**
+ * Insertion sort titles sharing their first depth bytes, only
+ * comparing what follows
+ */
+void radixInsertionSort(vector<TitleRef>& refs, size_t begin, size_t end, size_t depth) {
+    auto less = [depth](const TitleRef& a, const TitleRef& b) {
+        int order = memcmp(a.text + depth, b.text + depth, min(a.size, b.size) - depth);
+        return order != 0 ? order < 0 : a.size < b.size;
+    };
+
+    for (size_t i = begin + 1; i < end; ++i) {
+        TitleRef ref = refs[i];
+        size_t j = i;
+        for (; j > begin && less(ref, refs[j - 1]); --j) {
+            refs[j] = refs[j - 1];
+        }
+        refs[j] = ref;
+    }
+}
+
+/**
+ * Sort titles sharing their first depth bytes into 257 buckets on
+ * the next byte (titles ending there first), then each bucket on
+ * the byte after. Every byte is read once per level instead of once
+ * per comparison; buckets are filled in order, so the sort is stable.
+ *
+ * @param refs the titles, [begin, end) is sorted
+ * @param buffer scratch space as large as refs
+ * @param depth length of the prefix the titles share
+ */
+void radixSort(vector<TitleRef>& refs, vector<TitleRef>& buffer, size_t begin, size_t end, size_t depth) {
+    while (end - begin > RADIX_CUTOFF) {
+        size_t count[258] = { 0 };
+        for (size_t i = begin; i < end; ++i) {
+            ++count[radixBucket(refs[i], depth) + 1];
+        }
+
+        // one bucket holding everything: a longer shared prefix
+        if (count[radixBucket(refs[begin], depth) + 1] == end - begin) {
+            if (radixBucket(refs[begin], depth) == 0) {
+                return;
+            }
+            ++depth;
+            continue;
+        }
+
+        // count[b] becomes the offset where bucket b starts
+        for (size_t b = 1; b < 258; ++b) {
+            count[b] += count[b - 1];
+        }
+        for (size_t i = begin; i < end; ++i) {
+            buffer[begin + count[radixBucket(refs[i], depth)]++] = refs[i];
+        }
+        copy(buffer.begin() + begin, buffer.begin() + end, refs.begin() + begin);
+
+        // count[b] is now where bucket b + 1 starts, titles in
+        // bucket 0 have ended and are already in order
+        for (size_t b = 1; b < 257; ++b) {
+            if (count[b] - count[b - 1] > 1) {
+                radixSort(refs, buffer, begin + count[b - 1], begin + count[b], depth + 1);
+            }
+        }
+        return;
+    }
+    radixInsertionSort(refs, begin, end, depth);
+}
+
+/**
+ * Sort bids on title with an MSD radix sort, without moving them
+ *
+ * @param bids the bids to sort, left untouched
+ * @return the sorted order, bids[order[0]] has the lowest title;
+ *         equal titles keep their original order
+ */
+vector<unsigned int> radixOrder(const vector<Bid>& bids) {
+    vector<TitleRef> refs(bids.size());
+    for (size_t i = 0; i < bids.size(); ++i) {
+        refs[i].text = bids[i].title.data();
+        refs[i].size = bids[i].title.size();
+        refs[i].index = i;
+    }
+
+    vector<TitleRef> buffer(refs.size());
+    radixSort(refs, buffer, 0, refs.size(), 0);
+
+    vector<unsigned int> order(refs.size());
+    for (size_t i = 0; i < refs.size(); ++i) {
+        order[i] = refs[i].index;
+    }
+    return order;
+}
+
+//============================================================================
+// Parallel quick sort
+//============================================================================
+
+// ranges shorter than this are sorted on the thread that reaches them,
+// small enough that the 12k row monthly export still splits
+const int PARALLEL_GRAIN = 1 << 11;
+
+/**
+ * Quick sort a range on up to threads threads. Each partition hands
+ * its lower part to a new thread and keeps the higher part, the
+ * threads split between them in proportion to their sizes, until a
+ * part is down to one thread or PARALLEL_GRAIN items.
+ *
+ * @param items address of the vector instance to be sorted
+ * @param begin the beginning index to sort on
+ * @param end the ending index to sort on
+ * @param depthLimit partitioning levels left before heap sort
+ * @param threads threads this range may run on, the calling one included
+ * @param compare three-way comparison of two items
+ */
+template <typename T, typename Compare>
+void parallelIntroSort(vector<T>& items, int begin, int end, int depthLimit, unsigned int threads, Compare compare) {
+    if (threads <= 1 || end - begin + 1 < PARALLEL_GRAIN || depthLimit == 0) {
+        introSort(items, begin, end, depthLimit, compare);
+        return;
+    }
+
+    int low, high;
+    partition(items, begin, end, compare, low, high);
+
+    // both parts may be empty when the range is mostly the pivot
+    double lowSize = low - begin;
+    double highSize = end - high;
+    if (lowSize + highSize == 0) {
+        return;
+    }
+    unsigned int lowThreads = static_cast<unsigned int>(lround(threads * lowSize / (lowSize + highSize)));
+    lowThreads = min(max(lowThreads, 1u), threads - 1);
+
+    thread worker(parallelIntroSort<T, Compare>, ref(items), begin, low - 1, depthLimit - 1, lowThreads, compare);
+    parallelIntroSort(items, high + 1, end, depthLimit - 1, threads - lowThreads, compare);
+    worker.join();
+}
+
+/**
+ * Perform a quick sort over several threads
+ * Average performance: O(n log(n) / threads)
+ * Worst case performance O(n log(n))
+ *
+ * @param items address of the vector instance to be sorted
+ * @param threads number of threads, 0 for one per hardware thread
+ * @param compare three-way comparison of two items
+ */
+template <typename T, typename Compare>
+void parallelQuickSort(vector<T>& items, unsigned int threads, Compare compare) {
+    if (items.size() < 2) {
+        return;
+    }
+    if (threads == 0) {
+        threads = max(thread::hardware_concurrency(), 1u);
+    }
+    int end = items.size() - 1;
+    parallelIntroSort(items, 0, end, 2 * static_cast<int>(log2(end + 1)), threads, compare);
+}
+
+//============================================================================
+// Top K
+//============================================================================
+
+/**
+ * Return the first k bids in key order without sorting the others.
+ * A max heap holds the k best bids seen so far, with the worst of
+ * them on top; each bid is compared to that one only, so the cost
+ * is O(n log(k)) instead of O(n log(n)).
+ *
+ * @param bids the bids to search
+ * @param k how many bids to return
+ * @param key the sort key
+ * @return at most k bids in key order, ties in their original order
+ */
+template <typename Key>
+vector<Bid> topK(const vector<Bid>& bids, size_t k, Key key) {
+    auto before = [&bids, &key](unsigned int a, unsigned int b) {
+        int order = key(bids[a], bids[b]);
+        return order != 0 ? order < 0 : a < b;
+    };
+
+    vector<unsigned int> heap;
+    heap.reserve(min(k, bids.size()));
+    for (unsigned int i = 0; i < bids.size() && k > 0; ++i) {
+        if (heap.size() < k) {
+            heap.push_back(i);
+            push_heap(heap.begin(), heap.end(), before);
+        } else if (before(i, heap.front())) {
+            pop_heap(heap.begin(), heap.end(), before);
+            heap.back() = i;
+            push_heap(heap.begin(), heap.end(), before);
+        }
+    }
+    sort_heap(heap.begin(), heap.end(), before);
+
+    vector<Bid> top;
+    top.reserve(heap.size());
+    for (auto index : heap) {
+        top.push_back(bids[index]);
+    }
+    return top;
+}
+
+/**
+ * Display the first k bids in key order, then time the heap against
+ * a full quick sort of the bids, averaged over TOP_ROUNDS runs
+ *
+ * @param bids the loaded bids
+ * @param k how many bids to display
+ * @param key the sort key
+ */
+template <typename Key>
+void showTopBids(const vector<Bid>& bids, size_t k, Key key) {
+    const int TOP_ROUNDS = 5;
+
+    vector<Bid> top;
+    auto start = chrono::steady_clock::now();
+    for (int round = 0; round < TOP_ROUNDS; ++round) {
+        top = topK(bids, k, key);
+    }
+    chrono::duration<double, milli> heap = chrono::steady_clock::now() - start;
+
+    chrono::duration<double, milli> full(0);
+    for (int round = 0; round < TOP_ROUNDS; ++round) {
+        vector<Bid> copy = bids;
+        start = chrono::steady_clock::now();
+        quickSort(copy, 0, copy.size() - 1, key);
+        full += chrono::steady_clock::now() - start;
+    }
+
+    for (auto const& bid : top) {
+        displayBid(bid);
+    }
+
+    // a stable sort breaks ties the same way
+    vector<unsigned int> order = keyOrder(bids, key);
+    for (size_t i = 0; i < top.size(); ++i) {
+        if (bids[order[i]].bidId != top[i].bidId) {
+            cout << "(full sort disagrees at bid " << i + 1 << ")" << endl;
+            break;
+        }
+    }
+    cout << top.size() << " bids" << endl;
+    cout << "time: " << heap.count() / TOP_ROUNDS << " milliseconds for the top " << k << ", "
+         << full.count() / TOP_ROUNDS << " milliseconds for a full quick sort" << endl;
+}
+
+//============================================================================
+// Sort selection and benchmark
+//============================================================================
+
+// a sort of the bids, picked by name
+struct Sorter {
+    string name;
+    function<void(vector<Bid>&)> sort;
+};
+
+/**
+ * Every general sort on one key
+ *
+ * @param key the sort key
+ * @param threads number of threads of the parallel sort
+ */
+template <typename Key>
+vector<Sorter> keySorters(Key key, unsigned int threads) {
+    return {
+        { "quick", [key](vector<Bid>& bids) { quickSort(bids, 0, bids.size() - 1, key); } },
+        { "index", [key](vector<Bid>& bids) { applyOrder(bids, keyOrder(bids, key)); } },
+        { "parallel", [key, threads](vector<Bid>& bids) { parallelQuickSort(bids, threads, key); } },
+        { "std", [key](vector<Bid>& bids) {
+            sort(bids.begin(), bids.end(), [&key](const Bid& a, const Bid& b) { return key(a, b) < 0; });
+        } },
+    };
+}
+
+/**
+ * Every sort on a key, the first one is the default
+ *
+ * @param keyName one of SORT_KEYS
+ * @param threads number of threads of the parallel sort
+ * @return the sorts, empty for an unknown key
+ */
+vector<Sorter> sortersFor(string keyName, unsigned int threads) {
+    vector<Sorter> sorters;
+    visitKey(keyName, [&sorters, threads](auto key) { sorters = keySorters(key, threads); });
+
+    // radix sort only sorts titles
+    if (keyName == "title") {
+        sorters.insert(sorters.begin() + 2,
+                { "radix", [](vector<Bid>& bids) { applyOrder(bids, radixOrder(bids)); } });
+    }
+    return sorters;
+}
+
+/**
+ * Find a sort by name
+ *
+ * @param name the name of the sort
+ * @param keyName the key to sort on, one of SORT_KEYS
+ * @param threads number of threads of the parallel sort
+ * @param sorter set to the sort found
+ * @return false when no sort has that name
+ */
+bool findSorter(string name, string keyName, unsigned int threads, Sorter& sorter) {
+    for (auto const& candidate : sortersFor(keyName, threads)) {
+        if (candidate.name == name) {
+            sorter = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Check every sort on every key returns the bids in key order. The
+ * funds are rewritten to names sharing their first bytes, so key
+ * prefixes alone can't order them.
+ *
+ * @param bids the bids to sort
+ * @param threads number of threads of the parallel sort
+ */
+void checkKeySorts(const vector<Bid>& bids, unsigned int threads) {
+    const vector<csv::Symbol> FUNDS = { "General Fund", "General Obligation", "General", "Gen" };
+
+    vector<Bid> input = bids;
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i].fund = FUNDS[i % FUNDS.size()];
+    }
+
+    ios_base::fmtflags flags = cout.flags();
+    for (auto const& keyName : SORT_KEYS) {
+        cout << left << setw(12) << keyName;
+        visitKey(keyName, [&input, &keyName, threads](auto key) {
+            auto before = [&key](const Bid& a, const Bid& b) { return key(a, b) < 0; };
+            for (auto const& sorter : sortersFor(keyName, threads)) {
+                vector<Bid> copy = input;
+                sorter.sort(copy);
+                cout << " " << sorter.name << (is_sorted(copy.begin(), copy.end(), before) ? "" : "!");
+            }
+        });
+        cout << endl;
+    }
+    cout.flags(flags);
+    cout << "sorts by key on shared prefix funds, ! marks output out of key order" << endl;
+}
+
+/**
+ * Measure how the parallel sort scales from 1 to maxThreads threads
+ * on a random order of the bids, against the sequential quick sort
+ *
+ * @param bids the loaded bids
+ * @param maxThreads the largest number of threads to run
+ */
+void benchmarkParallelSort(const vector<Bid>& bids, unsigned int maxThreads) {
+    const int SORT_ROUNDS = 5;
+
+    vector<Bid> shuffled = bids;
+    shuffle(shuffled.begin(), shuffled.end(), mt19937(42));
+    auto byTitle = [](const Bid& a, const Bid& b) { return ByTitle()(a, b) < 0; };
+
+    vector<unsigned int> threadCounts;
+    for (unsigned int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    cout << bids.size() << " bids, " << SORT_ROUNDS << " rounds per run" << endl;
+    double baseTime = 0;
+    for (unsigned int threads : threadCounts) {
+        chrono::duration<double, milli> elapsed(0);
+        bool sorted = true;
+        for (int round = 0; round < SORT_ROUNDS; ++round) {
+            vector<Bid> copy = shuffled;
+            auto start = chrono::steady_clock::now();
+            parallelQuickSort(copy, threads, ByTitle());
+            elapsed += chrono::steady_clock::now() - start;
+            sorted = sorted && is_sorted(copy.begin(), copy.end(), byTitle);
+        }
+
+        double time = elapsed.count() / SORT_ROUNDS;
+        if (baseTime == 0) {
+            baseTime = time;
+        }
+        cout << "  " << threads << " threads: " << time << " ms, speedup "
+             << baseTime / time << (sorted ? "" : " (output not sorted)") << endl;
+    }
+}
+
+/**
+ * Time every sort on copies of the bids arranged as random, sorted,
+ * reverse sorted and duplicate heavy input (16 distinct titles),
+ * averaged over SORT_ROUNDS runs, and check every result is sorted,
+ * then how the parallel sort scales up to threads threads
+ *
+ * @param bids the loaded bids
+ * @param threads number of threads of the parallel sort
+ */
+void benchmarkSorts(const vector<Bid>& bids, unsigned int threads) {
+    const int SORT_ROUNDS = 5;
+
+    auto byTitle = [](const Bid& a, const Bid& b) { return ByTitle()(a, b) < 0; };
+
+    vector<pair<string, vector<Bid>>> inputs(4);
+    inputs[0].first = "random";
+    inputs[0].second = bids;
+    shuffle(inputs[0].second.begin(), inputs[0].second.end(), mt19937(42));
+
+    inputs[1].first = "sorted";
+    inputs[1].second = inputs[0].second;
+    sort(inputs[1].second.begin(), inputs[1].second.end(), byTitle);
+
+    inputs[2].first = "reverse";
+    inputs[2].second.assign(inputs[1].second.rbegin(), inputs[1].second.rend());
+
+    inputs[3].first = "duplicates";
+    inputs[3].second = inputs[0].second;
+    for (size_t i = 16; i < inputs[3].second.size(); ++i) {
+        inputs[3].second[i].title = inputs[3].second[i % 16].title;
+    }
+
+    vector<Sorter> sorters = sortersFor("title", threads);
+
+    ios_base::fmtflags flags = cout.flags();
+    streamsize precision = cout.precision();
+    cout << left << setw(12) << "input";
+    for (auto const& sorter : sorters) {
+        cout << right << setw(14) << sorter.name;
+    }
+    cout << endl;
+
+    for (auto const& input : inputs) {
+        cout << left << setw(12) << input.first << fixed << setprecision(2);
+        for (auto const& sorter : sorters) {
+            chrono::duration<double, milli> elapsed(0);
+            bool sorted = true;
+            for (int round = 0; round < SORT_ROUNDS; ++round) {
+                vector<Bid> copy = input.second;
+                auto start = chrono::steady_clock::now();
+                sorter.sort(copy);
+                elapsed += chrono::steady_clock::now() - start;
+                sorted = sorted && is_sorted(copy.begin(), copy.end(), byTitle);
+            }
+            cout << right << setw(11) << elapsed.count() / SORT_ROUNDS << " ms" << (sorted ? "" : "!");
+        }
+        cout << endl;
+    }
+    cout.flags(flags);
+    cout.precision(precision);
+    cout << bids.size() << " bids, " << SORT_ROUNDS << " rounds, ! marks unsorted output" << endl;
+
+    checkKeySorts(inputs[0].second, threads);
+    benchmarkParallelSort(bids, threads);
+}
+
+/**
+ * The one and only main() method
+ *
+ * @param --group-by=COLUMN print the group report for a column and
+ *        exit instead of showing the menu (optional)
+ * @param --value=COLUMN the amount column of the group report, empty
+ *        to only count (optional, defaults to Winning Bid)
+ * @param --sort=NAME the sort used by menu option 4: quick, index,
+ *        radix (titles only), parallel or std (optional, defaults
+ *        to quick)
+ * @param --key=KEY what menu option 4 and --top sort on: title, id,
+ *        date, fund (then highest winning bid) or amount (highest
+ *        first) (optional, defaults to title)
+ * @param --top=K display the first K bids by KEY and exit instead of
+ *        showing the menu (optional)
+ * @param --threads=N threads of the parallel sort, and the most
+ *        threads its benchmark runs (optional, defaults to the
+ *        number of hardware threads)
+ * @param --sort-file=OUTPUT sort the CSV file on disk into OUTPUT and
+ *        exit instead of showing the menu, for files larger than
+ *        memory (optional)
+ * @param --sort-column=COLUMN the column --sort-file sorts on
+ *        (optional, defaults to the first column)
+ * @param --key-type=TYPE how --sort-file compares the column: text,
+ *        number or date (optional, defaults to text)
+ * @param --memory=MB most megabytes of rows --sort-file holds in
+ *        memory (optional, defaults to 64)
+ * @param --temp-dir=DIR where --sort-file spills sorted runs
+ *        (optional, defaults to the system temporary directory)
+ * @param arg[1] path to CSV file to load from (optional)
+ */
+int main(int argc, char* argv[]) {
+
+    // process command line options, then arguments
+    string groupColumn;
+    string valueColumn = "Winning Bid";
+    string sortName = "quick";
+    string keyName = "title";
+    unsigned int threads = max(thread::hardware_concurrency(), 1u);
+    size_t topCount = 0;
+    string sortOutput;
+    string sortColumn = "0";
+    external::Options sortOptions;
+    int arg = 1;
+    for (; arg < argc && string(argv[arg]).rfind("--", 0) == 0; ++arg) {
+        string option = argv[arg];
+        if (option.rfind("--group-by=", 0) == 0) {
+            groupColumn = option.substr(11);
+        } else if (option.rfind("--value=", 0) == 0) {
+            valueColumn = option.substr(8);
+        } else if (option.rfind("--sort=", 0) == 0) {
+            sortName = option.substr(7);
+        } else if (option.rfind("--key=", 0) == 0) {
+            keyName = option.substr(6);
+        } else if (option.rfind("--top=", 0) == 0 && atoi(argv[arg] + 6) > 0) {
+            topCount = atoi(argv[arg] + 6);
+        } else if (option.rfind("--threads=", 0) == 0 && atoi(argv[arg] + 10) > 0) {
+            threads = atoi(argv[arg] + 10);
+        } else if (option.rfind("--sort-file=", 0) == 0) {
+            sortOutput = option.substr(12);
+        } else if (option.rfind("--sort-column=", 0) == 0) {
+            sortColumn = option.substr(14);
+        } else if (option == "--key-type=text") {
+            sortOptions.keyType = external::eTEXT;
+        } else if (option == "--key-type=number") {
+            sortOptions.keyType = external::eNUMBER;
+        } else if (option == "--key-type=date") {
+            sortOptions.keyType = external::eDATE;
+        } else if (option.rfind("--memory=", 0) == 0 && atoi(argv[arg] + 9) > 0) {
+            sortOptions.memoryBudget = static_cast<size_t>(atoi(argv[arg] + 9)) << 20;
+        } else if (option.rfind("--temp-dir=", 0) == 0) {
+            sortOptions.tempDir = option.substr(11);
+        } else {
+            cerr << "Unknown option " << option << endl;
+            return 1;
+        }
+    }
+
+    if (sortersFor(keyName, threads).empty()) {
+        cerr << "Unknown sort key " << keyName << ", expected one of:";
+        for (auto const& name : SORT_KEYS) {
+            cerr << " " << name;
+        }
+        cerr << endl;
+        return 1;
+    }
+    Sorter sorter;
+    if (!findSorter(sortName, keyName, threads, sorter)) {
+        cerr << "Unknown sort " << sortName << " by " << keyName << ", expected one of:";
+        for (auto const& candidate : sortersFor(keyName, threads)) {
+            cerr << " " << candidate.name;
+        }
+        cerr << endl;
+        return 1;
+    }
+
+    string csvPath;
+    switch (argc - arg) {
+    case 1:
+        csvPath = argv[arg];
+        break;
+    default:
+        csvPath = "eBid_Monthly_Sales.csv";
+    }
+
+    if (!groupColumn.empty()) {
+        return groupBids(csvPath, groupColumn, valueColumn) ? 0 : 1;
+    }
+
+    if (!sortOutput.empty()) {
+        return sortBidFile(csvPath, sortOutput, sortColumn, sortOptions) ? 0 : 1;
+    }
+
+    if (topCount > 0) {
+        vector<Bid> bids = loadBids(csvPath);
+        visitKey(keyName, [&bids, topCount](auto key) { showTopBids(bids, topCount, key); });
+        return 0;
+    }
+
+    // Define a vector to hold all the bids
+    vector<Bid> bids;
+
+    // and a column store of them for reports
+    BidTable table;
+
+    // Define a timer variable
+    clock_t ticks;
+
+    int choice = 0;
+    while (choice != 9) {
+        cout << "Menu:" << endl;
+        cout << "  1. Load Bids" << endl;
+        cout << "  2. Display All Bids" << endl;
+        cout << "  3. Selection Sort All Bids" << endl;
+        cout << "  4. Sort All Bids (" << sorter.name << " by " << keyName << ")" << endl;
+        cout << "  5. Report Bid Amounts" << endl;
+        cout << "  6. Group Bids By Column" << endl;
+        cout << "  7. Benchmark Sorts" << endl;
+        cout << "  8. Show Top K Bids" << endl;
+        cout << "  9. Exit" << endl;
+        cout << "Enter choice: ";
+        cin >> choice;
+
+        switch (choice) {
+
+        case 1:
+            // Initialize a timer variable before loading bids
+            ticks = clock();
+
+            // Complete the method call to load the bids
+            bids = loadBids(csvPath);
+            table = toBidTable(bids);
+
+            cout << bids.size() << " bids read" << endl;
+
+            // Calculate elapsed time and display result
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+            break;
+
+        case 2:
+            // Loop and display the bids read
+            for (int i = 0; i < bids.size(); ++i) {
+                displayBid(bids[i]);
+            }
+            cout << endl;
+
+            break;
+
+        // FIXME (1b): Invoke the selection sort and report timing results
+        case 3:
+            ticks = clock();
+
+            selectionSort(bids);
+
+            cout << bids.size() << " bids read" << endl;
+
+            ticks = clock() - ticks;
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+            break;
+
+        // FIXME (2b): Invoke the quick sort and report timing results
+        case 4:
+            ticks = clock();
+
+            sorter.sort(bids);
+
+            cout << bids.size() << " bids read" << endl;
+
+            ticks = clock() - ticks;
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+            break;
+
+        case 5:
+            reportAmounts(bids, table);
+
+            break;
+
+        case 6: {
+            string keyColumn, amountColumn;
+            cout << "Enter column to group by: ";
+            cin.ignore();
+            getline(cin, keyColumn);
+            cout << "Enter amount column (blank to only count): ";
+            getline(cin, amountColumn);
+
+            groupBids(csvPath, keyColumn, amountColumn);
+
+            break;
+        }
+
+        case 7:
+            benchmarkSorts(bids, threads);
+
+            break;
+
+        case 8: {
+            string topKey;
+            size_t k = 0;
+            cout << "Enter key (title, id, date, fund or amount) and K: ";
+            cin >> topKey >> k;
+            if (!visitKey(topKey, [&bids, k](auto key) { showTopBids(bids, k, key); })) {
+                cout << "Unknown key " << topKey << endl;
+            }
+
+            break;
+        }
+        }
+    }
+
+    cout << "Good bye." << endl;
+
+    return 0;
+}